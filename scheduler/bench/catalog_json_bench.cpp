@@ -0,0 +1,68 @@
+// catalog_json_bench.cpp - full-semester load from the scraped JSON file into
+// a CourseCatalog: file read + streaming parse, and parse alone from memory
+//
+// Build (from scheduler/):
+//   g++ -O3 -std=c++17 -I. bench/catalog_json_bench.cpp course_catalog.cpp section.cpp \
+//       time_utils.cpp week_mask.cpp -o bench/catalog_json_bench
+// Run:
+//   ./bench/catalog_json_bench [courses.json] [rounds]
+#include "course_catalog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Best and mean milliseconds of `rounds` runs of `once`
+std::pair<double, double> time_ms(int rounds, const std::function<void()>& once) {
+    double best = 1e300, total = 0;
+    for (int i = 0; i < rounds; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        once();
+        double ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+        best = std::min(best, ms);
+        total += ms;
+    }
+    return {best, rounds ? total / rounds : 0.0};
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "../ingestion/app/scraped_data/usc_20253_courses.json";
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::fprintf(stderr, "cannot open %s\n", path.c_str());
+        return 1;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    CourseCatalog catalog = CourseCatalog::load_json(path);
+    std::printf("%s: %.1f MB, semester %s, %zu classes, %zu sections, %d rounds\n",
+                path.c_str(), data.size() / 1e6, catalog.semester().c_str(),
+                catalog.class_count(), catalog.section_count(), rounds);
+
+    size_t sections = 0;
+    auto load = time_ms(rounds, [&] { sections += CourseCatalog::load_json(path).section_count(); });
+    auto parse = time_ms(rounds, [&] {
+        sections += CourseCatalog::parse_json(data.data(), data.size()).section_count();
+    });
+
+    std::printf("%-18s %10s %10s %14s\n", "phase", "best ms", "mean ms", "sections/ms");
+    auto row = [&](const char* name, std::pair<double, double> ms) {
+        std::printf("%-18s %10.2f %10.2f %14.0f\n", name, ms.first, ms.second,
+                    ms.first > 0 ? catalog.section_count() / ms.first : 0.0);
+    };
+    row("read + parse", load);
+    row("parse only", parse);
+    return sections == 0;   // keeps the loads from being optimised away
+}
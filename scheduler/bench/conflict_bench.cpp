@@ -0,0 +1,196 @@
+// conflict_bench.cpp - package-vs-package conflict test: legacy string path vs WeekMask,
+// plus the one-against-many WeekMaskBlock kernel (scalar and AVX2)
+//
+// Build (from scheduler/):
+//   g++ -O3 -std=c++17 -I. bench/conflict_bench.cpp section.cpp time_utils.cpp week_mask.cpp \
+//       -o bench/conflict_bench
+// Run:
+//   ./bench/conflict_bench [num_packages]
+#include "section.h"
+#include "time_utils.h"
+#include "week_mask.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Day matching as the pre-bitmap get_day_bits() did it: string compares on every call
+uint8_t legacy_day_bits(const Section& s) {
+    static const std::vector<std::pair<const char*, uint8_t>> names {
+        {"Mon",0x01},{"Monday",0x01},{"Tue",0x02},{"Tues",0x02},{"Tu",0x02},{"Tuesday",0x02},
+        {"Wed",0x04},{"Wednesday",0x04},{"Thu",0x08},{"Thur",0x08},{"Thurs",0x08},{"Th",0x08},
+        {"Thursday",0x08},{"Fri",0x10},{"Friday",0x10},{"Sat",0x20},{"Saturday",0x20},
+        {"Sun",0x40},{"Sunday",0x40}
+    };
+    uint8_t bits = 0;
+    for (const auto& day : s.get_meeting_days())
+        for (const auto& [name, bit] : names)
+            if (day == name) bits |= bit;
+    return bits;
+}
+
+// The string-based packages_conflict() the generator used before WeekMask
+bool legacy_conflict(const std::vector<Section>& pkg1, const std::vector<Section>& pkg2) {
+    if (pkg1.empty() || pkg2.empty()) return false;
+    uint8_t days1 = 0, days2 = 0;
+    for (const auto& s : pkg1) days1 |= legacy_day_bits(s);
+    for (const auto& s : pkg2) days2 |= legacy_day_bits(s);
+    if ((days1 & days2) == 0) return false;
+
+    for (const auto& sec1 : pkg1) {
+        uint8_t d1 = legacy_day_bits(sec1);
+        if (d1 == 0) continue;
+        for (const auto& sec2 : pkg2) {
+            uint8_t d2 = legacy_day_bits(sec2);
+            if ((d1 & d2) == 0) continue;
+            if (sec1.get_start_time().empty() || sec1.get_end_time().empty() ||
+                sec2.get_start_time().empty() || sec2.get_end_time().empty() ||
+                sec1.get_start_time() == "TBA" || sec2.get_start_time() == "TBA") continue;
+            if (TimeUtils::times_overlap(sec1.get_start_time(), sec1.get_end_time(),
+                                         sec2.get_start_time(), sec2.get_end_time()))
+                return true;
+        }
+    }
+    return false;
+}
+
+// Same decision as ScheduleGenerator::packages_conflict
+bool mask_conflict(const WeekMask& m1, const std::vector<Section>& pkg1,
+                   const WeekMask& m2, const std::vector<Section>& pkg2) {
+    if (!m1.intersects(m2)) return false;
+    if (m1.exact && m2.exact) return true;
+    for (const auto& a : pkg1)
+        for (const auto& b : pkg2)
+            if (meetings_overlap(a, b)) return true;
+    return false;
+}
+
+std::string format_time(int minute) {
+    int h = minute / 60, m = minute % 60;
+    const char* ampm = h >= 12 ? "pm" : "am";
+    if (h > 12) h -= 12;
+    if (h == 0) h = 12;
+    char buf[16];
+    std::snprintf(buf, sizeof buf, "%d:%02d %s", h, m, ampm);
+    return buf;
+}
+
+// Random section with USC-like meeting patterns
+Section random_section(std::mt19937& rng, const char* type) {
+    static const std::vector<std::vector<std::string>> patterns {
+        {"Mon","Wed"}, {"Tue","Thu"}, {"Mon","Wed","Fri"}, {"Mon"}, {"Tue"},
+        {"Wed"}, {"Thu"}, {"Fri"}, {}
+    };
+    static const int durations[] = {50, 80, 110, 170};
+    const auto& days = patterns[rng() % patterns.size()];
+    int start = 8 * 60 + static_cast<int>(rng() % 25) * 30;          // 8:00 am .. 8:00 pm
+    if (rng() % 50 == 0) start += 2;                                 // the odd unaligned start
+    int end = start + durations[rng() % 4];
+    std::string days_str = "{";
+    for (size_t i = 0; i < days.size(); ++i) days_str += (i ? "," : "") + days[i];
+    days_str += "}";
+    return Section(type, {days_str}, {format_time(start), format_time(end)},
+                   "THH 101", 10, 40, "Jane Doe", std::to_string(rng() % 90000 + 10000));
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int num_packages = argc > 1 ? std::atoi(argv[1]) : 2000;
+    std::mt19937 rng(20253);
+
+    std::vector<std::vector<Section>> packages;
+    for (int i = 0; i < num_packages; ++i) {
+        std::vector<Section> pkg{random_section(rng, "Lecture")};
+        for (int extra = rng() % 3; extra > 0; --extra)
+            pkg.push_back(random_section(rng, extra == 1 ? "Discussion" : "Lab"));
+        packages.push_back(std::move(pkg));
+    }
+
+    using clock = std::chrono::steady_clock;
+
+    // Masks are compiled once at load, so compile time is reported separately
+    auto t0 = clock::now();
+    std::vector<WeekMask> masks;
+    masks.reserve(packages.size());
+    for (const auto& pkg : packages) masks.push_back(WeekMask::of(pkg));
+    auto t1 = clock::now();
+
+    size_t pairs = 0, legacy_hits = 0, mask_hits = 0, mismatches = 0;
+    std::vector<char> legacy_result;
+    legacy_result.reserve(size_t(num_packages) * num_packages / 2);
+    for (int i = 0; i < num_packages; ++i)
+        for (int j = i + 1; j < num_packages; ++j) {
+            bool c = legacy_conflict(packages[i], packages[j]);
+            legacy_result.push_back(c);
+            legacy_hits += c;
+        }
+    auto t2 = clock::now();
+
+    size_t k = 0;
+    for (int i = 0; i < num_packages; ++i)
+        for (int j = i + 1; j < num_packages; ++j, ++k) {
+            bool c = mask_conflict(masks[i], packages[i], masks[j], packages[j]);
+            mask_hits += c;
+            mismatches += (c != static_cast<bool>(legacy_result[k]));
+        }
+    auto t3 = clock::now();
+    pairs = k;
+
+    auto ns = [](clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(d).count();
+    };
+    std::printf("packages: %d   pairs tested: %zu   conflicts: %zu\n",
+                num_packages, pairs, legacy_hits);
+    std::printf("compile masks : %10.3f ms total (%.1f ns / package)\n",
+                ns(t1 - t0) / 1e6, double(ns(t1 - t0)) / num_packages);
+    std::printf("string path   : %10.3f ms total (%.1f ns / pair)\n",
+                ns(t2 - t1) / 1e6, double(ns(t2 - t1)) / pairs);
+    std::printf("bitmap path   : %10.3f ms total (%.1f ns / pair)\n",
+                ns(t3 - t2) / 1e6, double(ns(t3 - t2)) / pairs);
+    std::printf("speedup       : %10.1fx\n", double(ns(t2 - t1)) / double(ns(t3 - t2)));
+    std::printf("mismatches    : %zu (bitmap conflicts: %zu)\n", mismatches, mask_hits);
+
+    // One package against every package at once, as a compatibility row is
+    // filled; checked against the pairwise mask test
+    std::vector<const WeekMask*> mask_ptrs;
+    for (const auto& m : masks) mask_ptrs.push_back(&m);
+    WeekMaskBlock block(mask_ptrs);
+    std::vector<uint64_t> row((num_packages + 63) / 64);
+    auto run_block = [&](bool simd, size_t& wrong) {
+        auto start = clock::now();
+        for (int i = 0; i < num_packages; ++i) {
+            block.disjoint_from(masks[i], row.data(), simd);
+            for (int j = 0; j < num_packages; ++j)
+                wrong += ((row[j / 64] >> (j % 64)) & 1) == masks[i].intersects(masks[j]);
+        }
+        return clock::now() - start;
+    };
+    // Verification is timed separately so only the kernel is reported
+    auto kernel_only = [&](bool simd) {
+        auto start = clock::now();
+        for (int rep = 0; rep < 5; ++rep)
+            for (int i = 0; i < num_packages; ++i) block.disjoint_from(masks[i], row.data(), simd);
+        return (clock::now() - start) / 5;
+    };
+    size_t block_wrong = 0;
+    run_block(false, block_wrong);
+    if (WeekMaskBlock::simd_available()) run_block(true, block_wrong);
+    const double tested = double(num_packages) * num_packages;
+    auto scalar_ns = ns(kernel_only(false));
+    std::printf("block scalar  : %10.3f ms total (%.0f packages / us)\n",
+                scalar_ns / 1e6, tested / (scalar_ns / 1e3));
+    if (WeekMaskBlock::simd_available()) {
+        auto simd_ns = ns(kernel_only(true));
+        std::printf("block avx2    : %10.3f ms total (%.0f packages / us)\n",
+                    simd_ns / 1e6, tested / (simd_ns / 1e3));
+    } else {
+        std::printf("block avx2    : not supported on this CPU\n");
+    }
+    std::printf("block errors  : %zu\n", block_wrong);
+    return mismatches == 0 && block_wrong == 0 ? 0 : 1;
+}
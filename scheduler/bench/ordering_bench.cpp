@@ -0,0 +1,111 @@
+// ordering_bench.cpp - search frontier per depth for each spot ordering
+//
+// Runs the exhaustive search (no pruning) over real course combinations
+// with the spots as listed, most-constrained-first, and dynamic ordering,
+// and prints how many partial schedules were built at each depth.
+//
+// Build (from scheduler/):
+//   g++ -O3 -std=c++17 -I. -I/usr/include/postgresql bench/ordering_bench.cpp \
+//       $(ls *.cpp | grep -v '^main.cpp$') -lpq -pthread -o bench/ordering_bench
+// Run (database settings as for the scheduler: USC_DB_USER, USC_DB_PASSWORD, ...,
+// or USC_CATALOG=<scraped semester JSON> to read sections from that file instead):
+//   ./bench/ordering_bench ["CSCI 103,CSCI 104|WRIT 150|CSCI 170" ...]
+#include "database.h"
+#include "memory_catalog.h"
+#include "schedule_generator.h"
+#include "user_preferences.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::string env_or(const char* name, const char* fallback) {
+    const char* value = std::getenv(name);
+    return value && *value ? value : fallback;
+}
+
+std::vector<std::vector<std::string>> parse_spots(const std::string& text) {
+    std::vector<std::vector<std::string>> spots;
+    std::istringstream spot_stream(text);
+    std::string spot;
+    while (std::getline(spot_stream, spot, '|')) {
+        std::vector<std::string> classes;
+        std::istringstream class_stream(spot);
+        std::string code;
+        while (std::getline(class_stream, code, ',')) classes.push_back(code);
+        spots.push_back(classes);
+    }
+    return spots;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> combos;
+    for (int i = 1; i < argc; ++i) combos.push_back(argv[i]);
+    if (combos.empty()) {
+        combos = {
+            "CSCI 103,CSCI 104|WRIT 150|BISC 120,MATH 126|CSCI 170",
+            "CSCI 103,CSCI 104|WRIT 150|BISC 120,MATH 126|CSCI 170|PHYS 151,CHEM 105A",
+            "WRIT 150|CSCI 104|MATH 126|BISC 120",
+        };
+    }
+
+    std::shared_ptr<CatalogSource> db;
+    std::string catalog = env_or("USC_CATALOG", "");
+    if (!catalog.empty()) {
+        db = std::make_shared<FileCatalog>(catalog);
+    } else {
+        db = std::make_shared<DatabaseConnection>(
+            env_or("USC_DB_NAME", "usc_sched"), env_or("USC_DB_USER", ""),
+            env_or("USC_DB_PASSWORD", ""), env_or("USC_DB_HOST", "localhost"),
+            std::atoi(env_or("USC_DB_PORT", "5432").c_str()), env_or("USC_SEMESTER", "20253"));
+    }
+    ScheduleGenerator generator(db);
+
+    const std::pair<SpotOrdering, const char*> orderings[] = {
+        {SpotOrdering::AsListed, "as listed"},
+        {SpotOrdering::MostConstrained, "most constrained"},
+        {SpotOrdering::Dynamic, "dynamic"},
+    };
+
+    int failures = 0;
+    for (const auto& combo : combos) {
+        auto table = generator.prepare_packages(parse_spots(combo));
+        if (!table) {
+            std::printf("\n%s: no schedules possible\n", combo.c_str());
+            continue;
+        }
+        std::printf("\n%s\n", combo.c_str());
+        std::printf("  %-17s %10s %10s %10s  nodes per depth\n", "ordering", "nodes", "schedules", "ms");
+
+        size_t reference = 0;
+        for (const auto& [ordering, name] : orderings) {
+            generator.set_spot_ordering(ordering);
+            auto start = std::chrono::steady_clock::now();
+            size_t found = generator.for_each_valid_schedule(
+                *table, [](const PackedSchedule&, unsigned) { return true; }, 1);
+            double ms = std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - start).count();
+
+            const SearchStats& stats = generator.last_search_stats();
+            size_t nodes = 0;
+            std::string per_depth;
+            for (size_t count : stats.nodes_per_depth) {
+                nodes += count;
+                per_depth += " " + std::to_string(count);
+            }
+            std::printf("  %-17s %10zu %10zu %10.2f %s\n", name, nodes, found, ms, per_depth.c_str());
+
+            if (ordering == SpotOrdering::AsListed) reference = found;
+            else if (found != reference) ++failures;   // every ordering must find the same set
+        }
+    }
+    std::cout << (failures ? "MISMATCH in schedule counts\n" : "") << std::flush;
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,98 @@
+// prepared_bench.cpp - per-call latency of the hot DatabaseConnection queries,
+// full SQL text every call (PQexecParams) vs prepared once (PQexecPrepared)
+//
+// Replays the rating lookups the scoring phase makes: every (instructor,
+// class) pair of the lecture sections of the given classes, several rounds,
+// on a fresh connection per mode. Section and section-type lookups are
+// timed the same way.
+//
+// Build (from scheduler/):
+//   g++ -O3 -std=c++17 -I. -I/usr/include/postgresql bench/prepared_bench.cpp \
+//       database.cpp catalog_source.cpp section.cpp time_utils.cpp week_mask.cpp -lpq -o bench/prepared_bench
+// Run (database settings as for the scheduler: USC_DB_USER, USC_DB_PASSWORD, ...):
+//   ./bench/prepared_bench [rounds] ["CSCI 103,CSCI 104,WRIT 150,..."]
+#include "database.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::string env_or(const char* name, const char* fallback) {
+    const char* value = std::getenv(name);
+    return value && *value ? value : fallback;
+}
+
+std::shared_ptr<DatabaseConnection> connect(bool prepared) {
+    auto db = std::make_shared<DatabaseConnection>(
+        env_or("USC_DB_NAME", "usc_sched"), env_or("USC_DB_USER", ""),
+        env_or("USC_DB_PASSWORD", ""), env_or("USC_DB_HOST", "localhost"),
+        std::atoi(env_or("USC_DB_PORT", "5432").c_str()), env_or("USC_SEMESTER", "20253"));
+    db->set_prepared_statements(prepared);
+    return db;
+}
+
+// Mean microseconds per call of `calls` calls of `one(i)`
+double time_calls(size_t calls, const std::function<void(size_t)>& one) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < calls; ++i) one(i);
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    return calls ? double(us) / calls : 0.0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 5;
+    std::string list = argc > 2 ? argv[2]
+        : "CSCI 103,CSCI 104,CSCI 170,WRIT 150,BISC 120,MATH 126,PHYS 151,CHEM 105A";
+    std::vector<std::string> classes;
+    std::istringstream stream(list);
+    for (std::string code; std::getline(stream, code, ',');) classes.push_back(code);
+
+    // Lookups the evaluator makes while scoring: one per lecture instructor and class
+    std::vector<std::pair<std::string, std::string>> lookups;
+    for (const auto& [code, groups] : connect(true)->find_sections_for_classes(classes))
+        for (const auto& group : groups)
+            for (const auto& section : group)
+                if (section.get_section_type() == "Lecture" && !section.get_instructor().empty())
+                    lookups.emplace_back(section.get_instructor(), code);
+    if (lookups.empty()) {
+        std::fprintf(stderr, "no lecture instructors found (is the database reachable?)\n");
+        return 1;
+    }
+    std::printf("classes: %zu   rating lookups per round: %zu   rounds: %d\n",
+                classes.size(), lookups.size(), rounds);
+
+    double rating_us[2], section_us[2], types_us[2];
+    for (int prepared = 0; prepared < 2; ++prepared) {
+        auto db = connect(prepared);
+        db->get_professor_ratings(lookups[0].first, lookups[0].second);   // connection warm-up
+        rating_us[prepared] = time_calls(lookups.size() * rounds, [&](size_t i) {
+            const auto& [name, code] = lookups[i % lookups.size()];
+            db->get_professor_ratings(name, code);
+        });
+        section_us[prepared] = time_calls(classes.size() * rounds, [&](size_t i) {
+            db->find_sections_for_class(classes[i % classes.size()]);
+        });
+        types_us[prepared] = time_calls(classes.size() * rounds, [&](size_t i) {
+            db->get_required_section_types(classes[i % classes.size()]);
+        });
+    }
+
+    std::printf("%-16s %12s %12s %9s\n", "query", "text us", "prepared us", "speedup");
+    auto row = [](const char* name, const double* us) {
+        std::printf("%-16s %12.1f %12.1f %8.2fx\n", name, us[0], us[1], us[1] > 0 ? us[0] / us[1] : 0.0);
+    };
+    row("ratings", rating_us);
+    row("sections", section_us);
+    row("section types", types_us);
+    return 0;
+}
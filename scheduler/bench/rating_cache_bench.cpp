@@ -0,0 +1,108 @@
+// rating_cache_bench.cpp - professor-rating lookups from many threads: one
+// std::map per thread (what every scoring thread used to keep) vs one
+// ConcurrentRatingCache shared by all of them. A fetch sleeps for a
+// simulated database round-trip and is counted.
+//
+// Build (from scheduler/):
+//   g++ -O3 -std=c++17 -I. bench/rating_cache_bench.cpp concurrent_rating_cache.cpp \
+//       section.cpp time_utils.cpp week_mask.cpp catalog_source.cpp -pthread -o bench/rating_cache_bench
+// Run:
+//   ./bench/rating_cache_bench [threads] [lookups_per_thread] [distinct_pairs] [fetch_us]
+#include "concurrent_rating_cache.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Key = ConcurrentRatingCache::Key;
+using Rating = ConcurrentRatingCache::Rating;
+
+std::atomic<size_t> fetch_count{0};
+int fetch_us = 200;
+
+Rating slow_fetch(const Key& key) {
+    fetch_count.fetch_add(1, std::memory_order_relaxed);
+    std::this_thread::sleep_for(std::chrono::microseconds(fetch_us));
+    Rating r;
+    r.quality = double(key.first.size() % 5) + 0.5;
+    r.difficulty = double(key.second.size() % 5);
+    return r;
+}
+
+// Popular instructors come up far more often, as across real requests
+std::vector<std::vector<Key>> make_workload(int threads, int lookups, int distinct) {
+    std::vector<Key> pairs;
+    for (int i = 0; i < distinct; ++i) {
+        pairs.push_back({"Instructor " + std::to_string(i), "CSCI " + std::to_string(100 + i % 400)});
+    }
+    std::vector<std::vector<Key>> work(threads);
+    for (int t = 0; t < threads; ++t) {
+        std::mt19937 rng(1234 + t);
+        std::geometric_distribution<int> popularity(8.0 / distinct);
+        for (int i = 0; i < lookups; ++i) work[t].push_back(pairs[popularity(rng) % distinct]);
+    }
+    return work;
+}
+
+template <typename PerThread>
+double run(int threads, const PerThread& body) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) pool.emplace_back(body, t);
+    for (auto& th : pool) th.join();
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int threads = argc > 1 ? std::atoi(argv[1]) : 8;
+    int lookups = argc > 2 ? std::atoi(argv[2]) : 20000;
+    int distinct = argc > 3 ? std::atoi(argv[3]) : 2000;
+    fetch_us = argc > 4 ? std::atoi(argv[4]) : 200;
+    auto work = make_workload(threads, lookups, distinct);
+    std::set<Key> touched;
+    for (const auto& keys : work) touched.insert(keys.begin(), keys.end());
+
+    std::atomic<size_t> mismatches{0};
+    fetch_count = 0;
+    double map_ms = run(threads, [&](int t) {
+        std::map<Key, Rating> cache;
+        for (const auto& key : work[t]) {
+            auto it = cache.find(key);
+            if (it == cache.end()) it = cache.emplace(key, slow_fetch(key)).first;
+            if (it->second.quality != double(key.first.size() % 5) + 0.5) ++mismatches;
+        }
+    });
+    size_t map_fetches = fetch_count.load();
+
+    fetch_count = 0;
+    ConcurrentRatingCache shared(distinct * 2);
+    double shared_ms = run(threads, [&](int t) {
+        for (const auto& key : work[t]) {
+            Rating r = shared.get(key, [&] { return slow_fetch(key); });
+            if (r.quality != double(key.first.size() % 5) + 0.5) ++mismatches;
+        }
+    });
+    size_t shared_fetches = fetch_count.load();
+    ConcurrentRatingCache::Stats stats = shared.stats();
+
+    std::printf("threads: %d   lookups: %d each   distinct pairs: %d   fetch: %d us\n",
+                threads, lookups, distinct, fetch_us);
+    std::printf("map per thread : %10.1f ms   %7zu fetches\n", map_ms, map_fetches);
+    std::printf("shared cache   : %10.1f ms   %7zu fetches   (%zu hits, %zu waited on another fetch)\n",
+                shared_ms, shared_fetches, stats.hits, stats.waits);
+    std::printf("pairs used     : %10zu      (shared cache fetches each exactly once: %s)\n",
+                touched.size(), shared_fetches == touched.size() ? "yes" : "NO");
+    std::printf("speedup        : %10.1fx\n", map_ms / shared_ms);
+    std::printf("mismatches     : %zu\n", mismatches.load());
+    return mismatches.load() == 0 && shared_fetches == touched.size() ? 0 : 1;
+}
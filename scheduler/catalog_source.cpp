@@ -0,0 +1,21 @@
+#include "catalog_source.h"
+
+std::map<std::string, std::vector<std::vector<Section>>> CatalogSource::find_sections_for_classes(
+    const std::vector<std::string>& class_codes) {
+    std::map<std::string, std::vector<std::vector<Section>>> result;
+    for (const auto& code : class_codes) {
+        if (result.count(code)) continue;
+        auto groups = find_sections_for_class(code);
+        if (!groups.empty()) result[code] = std::move(groups);
+    }
+    return result;
+}
+
+bool CatalogSource::get_professor_ratings_bulk(
+    const std::vector<std::pair<std::string, std::string>>& lookups,
+    std::vector<ProfessorRating>& out) {
+    out.clear();
+    out.reserve(lookups.size());
+    for (const auto& [name, code] : lookups) out.push_back(get_professor_ratings(name, code));
+    return true;
+}
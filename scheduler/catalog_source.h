@@ -0,0 +1,59 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include "section.h"
+
+// Where the scheduler reads sections and professor ratings from. Generator,
+// evaluator and Scheduler only use this interface; DatabaseConnection reads
+// Postgres, MemoryCatalog serves data held in the process and FileCatalog
+// loads a scraped semester file, so runs and benchmarks need no database.
+// Sources must be created with std::make_shared (see open_another).
+class CatalogSource : public std::enable_shared_from_this<CatalogSource> {
+public:
+    struct ProfessorRating {
+        double quality = 0.0;
+        double difficulty = 0.0;
+        double would_take_again = 0.0;
+        double course_specific_quality = 0.0;
+        double course_specific_difficulty = 0.0;
+    };
+
+    virtual ~CatalogSource() = default;
+
+    // A class's sections grouped by type, in type order; empty if unknown
+    virtual std::vector<std::vector<Section>> find_sections_for_class(const std::string& class_code) = 0;
+
+    // find_sections_for_class for every listed code; codes without sections
+    // are absent. Sources that can do better than one call per code override it.
+    virtual std::map<std::string, std::vector<std::vector<Section>>> find_sections_for_classes(
+        const std::vector<std::string>& class_codes);
+
+    // Section types a class has ("Lecture" if none are known)
+    virtual std::set<std::string> get_required_section_types(const std::string& class_code) const = 0;
+
+    // Course-specific numbers when there are any, else the professor's
+    // overall ones, else zeros
+    virtual ProfessorRating get_professor_ratings(const std::string& professor_name,
+                                                  const std::string& class_code) = 0;
+
+    // get_professor_ratings for every pair; out[i] belongs to lookups[i].
+    // False if the lookup failed and the caller should fall back to single calls.
+    virtual bool get_professor_ratings_bulk(const std::vector<std::pair<std::string, std::string>>& lookups,
+                                            std::vector<ProfessorRating>& out);
+
+    virtual bool is_connected() const { return true; }
+
+    // Names the data behind this source (database and semester, or file),
+    // so state kept between requests - cursors, reused packages - is never
+    // applied to a different source's sections
+    virtual std::string source_id() const = 0;
+
+    // A source with the same data for another thread to use alongside this
+    // one: a new connection for a database, the same object for sources
+    // that are safe to share
+    virtual std::shared_ptr<CatalogSource> open_another() = 0;
+};
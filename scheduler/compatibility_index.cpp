@@ -0,0 +1,52 @@
+// compatibility_index.cpp
+#include "compatibility_index.h"
+#include <algorithm>
+
+CompatibilityIndex::CompatibilityIndex(const std::vector<size_t>& spot_sizes)
+    : spot_sizes_(spot_sizes) {
+    const size_t n = spot_sizes_.size();
+
+    // One block of spot_size(a) rows x words(b) per ordered spot pair (a != b)
+    offsets_.assign(n * n, 0);
+    size_t total = 0;
+    for (size_t a = 0; a < n; ++a)
+        for (size_t b = 0; b < n; ++b) {
+            offsets_[a * n + b] = total;
+            if (a != b) total += spot_sizes_[a] * words(b);
+        }
+    bits_.assign(total, 0);
+}
+
+CompatibilityIndex::CompatibilityIndex(const std::vector<size_t>& spot_sizes,
+                                       const RowFill& fill)
+    : CompatibilityIndex(spot_sizes) {
+    for (size_t a = 0; a < num_spots(); ++a)
+        for (size_t b = a + 1; b < num_spots(); ++b) compute_pair(a, b, fill);
+}
+
+void CompatibilityIndex::compute_pair(size_t a, size_t b, const RowFill& fill) {
+    // Each unordered pair is tested once and written in both directions
+    for (size_t p = 0; p < spot_sizes_[a]; ++p) {
+        Word* row_ab = mutable_row(a, p, b);
+        fill(a, p, b, row_ab);
+        for_each_bit(row_ab, words(b), [&](size_t q) {
+            mutable_row(b, q, a)[p / WORD_BITS] |= Word(1) << (p % WORD_BITS);
+        });
+    }
+    pairs_tested_ += spot_sizes_[a] * spot_sizes_[b];
+}
+
+void CompatibilityIndex::copy_pair(size_t a, size_t b, const CompatibilityIndex& from,
+                                   size_t from_a, size_t from_b) {
+    for (size_t p = 0; p < spot_sizes_[a]; ++p)
+        std::copy_n(from.row(from_a, p, from_b), words(b), mutable_row(a, p, b));
+    for (size_t q = 0; q < spot_sizes_[b]; ++q)
+        std::copy_n(from.row(from_b, q, from_a), words(a), mutable_row(b, q, a));
+}
+
+void CompatibilityIndex::fill_all(size_t spot, Word* out) const {
+    const size_t num_words = words(spot);
+    for (size_t w = 0; w < num_words; ++w) out[w] = ~Word(0);
+    if (size_t tail = spot_sizes_[spot] % WORD_BITS)
+        out[num_words - 1] = (Word(1) << tail) - 1;
+}
@@ -0,0 +1,66 @@
+// compatibility_index.h
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Package-vs-package compatibility for every pair of spots, computed once per
+// request and stored as packed bitsets. row(a, p, b) has bit q set when
+// package p of spot a can share a schedule with package q of spot b, so the
+// options left for a spot are the AND of the rows of the packages already
+// chosen.
+class CompatibilityIndex {
+public:
+    using Word = uint64_t;
+    static constexpr size_t WORD_BITS = 64;
+    // Writes words(spot_b) words: bit q set when package q of spot_b fits pkg_a
+    using RowFill = std::function<void(size_t spot_a, size_t pkg_a, size_t spot_b, Word* row)>;
+
+    CompatibilityIndex() = default;
+    // All bits clear; fill with compute_pair / copy_pair
+    explicit CompatibilityIndex(const std::vector<size_t>& spot_sizes);
+    // Every pair of spots computed
+    CompatibilityIndex(const std::vector<size_t>& spot_sizes, const RowFill& fill);
+
+    // Fill the a -> b rows one package of a at a time and mirror them into b -> a
+    void compute_pair(size_t a, size_t b, const RowFill& fill);
+    // Take the a/b blocks from `from`, where the same packages sit in spots
+    // from_a/from_b (the package order within each spot must match)
+    void copy_pair(size_t a, size_t b, const CompatibilityIndex& from, size_t from_a, size_t from_b);
+
+    size_t num_spots() const { return spot_sizes_.size(); }
+    size_t spot_size(size_t spot) const { return spot_sizes_[spot]; }
+    size_t words(size_t spot) const { return (spot_sizes_[spot] + WORD_BITS - 1) / WORD_BITS; }
+
+    const Word* row(size_t spot, size_t pkg, size_t other_spot) const {
+        return bits_.data() + offsets_[spot * num_spots() + other_spot] + pkg * words(other_spot);
+    }
+
+    size_t memory_bytes() const { return bits_.size() * sizeof(Word); }
+    size_t pairs_tested() const { return pairs_tested_; }
+
+    // All packages of `spot` set, padding bits clear
+    void fill_all(size_t spot, Word* out) const;
+
+    template <typename F>
+    static void for_each_bit(const Word* bits, size_t num_words, F&& f) {
+        for (size_t w = 0; w < num_words; ++w) {
+            Word word = bits[w];
+            while (word) {
+                f(w * WORD_BITS + static_cast<size_t>(__builtin_ctzll(word)));
+                word &= word - 1;
+            }
+        }
+    }
+
+private:
+    std::vector<size_t> spot_sizes_;
+    std::vector<size_t> offsets_;   // [spot * num_spots + other_spot] → first word of that block
+    std::vector<Word> bits_;
+    size_t pairs_tested_ = 0;
+
+    Word* mutable_row(size_t spot, size_t pkg, size_t other_spot) {
+        return bits_.data() + offsets_[spot * num_spots() + other_spot] + pkg * words(other_spot);
+    }
+};
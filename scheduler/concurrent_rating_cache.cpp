@@ -0,0 +1,263 @@
+// concurrent_rating_cache.cpp
+#include "concurrent_rating_cache.h"
+#include <algorithm>
+
+namespace {
+
+// Instructor names reach the sources with their Postgres array quoting at
+// times and without it at others; every source strips it before matching,
+// so both spellings share one entry
+ConcurrentRatingCache::Key rating_key(const std::string& professor_name, const std::string& class_code) {
+    std::string name = professor_name;
+    name.erase(std::remove_if(name.begin(), name.end(),
+                              [](char c) { return c == '{' || c == '}' || c == '"'; }),
+               name.end());
+    return {std::move(name), class_code};
+}
+
+} // namespace
+
+ConcurrentRatingCache::ConcurrentRatingCache(size_t max_entries)
+    : max_entries_(std::max<size_t>(1, max_entries)) {
+    // At most half full, so probe runs stay short
+    size_t slots = 1;
+    while (slots < 2 * max_entries_) slots <<= 1;
+    slots_.reset(new std::atomic<Node*>[slots]);
+    for (size_t i = 0; i < slots; ++i) slots_[i].store(nullptr, std::memory_order_relaxed);
+    mask_ = slots - 1;
+}
+
+ConcurrentRatingCache::~ConcurrentRatingCache() {
+    for (size_t i = 0; i <= mask_; ++i) delete slots_[i].load(std::memory_order_relaxed);
+}
+
+uint64_t ConcurrentRatingCache::hash_key(const Key& key) {
+    uint64_t h = std::hash<std::string>()(key.first);
+    return h ^ (std::hash<std::string>()(key.second) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+}
+
+const ConcurrentRatingCache::Node* ConcurrentRatingCache::lookup(const Key& key, uint64_t hash) const {
+    for (size_t probe = 0, i = hash & mask_; probe <= mask_; ++probe, i = (i + 1) & mask_) {
+        const Node* node = slots_[i].load(std::memory_order_acquire);
+        if (!node) return nullptr;
+        if (node->hash == hash && node->key == key) return node;
+    }
+    return nullptr;
+}
+
+ConcurrentRatingCache::Node* ConcurrentRatingCache::lookup_or_claim(const Key& key, uint64_t hash,
+                                                                    bool& owned) {
+    owned = false;
+    Node* fresh = nullptr;
+    auto discard = [&] {
+        if (!fresh) return;
+        delete fresh;
+        size_.fetch_sub(1, std::memory_order_relaxed);
+    };
+
+    for (size_t probe = 0, i = hash & mask_; probe <= mask_; ++probe, i = (i + 1) & mask_) {
+        Node* node = slots_[i].load(std::memory_order_acquire);
+        if (!node) {
+            if (!fresh) {
+                if (size_.fetch_add(1, std::memory_order_relaxed) >= max_entries_) {
+                    size_.fetch_sub(1, std::memory_order_relaxed);
+                    return nullptr;
+                }
+                fresh = new Node(hash, key);
+            }
+            if (slots_[i].compare_exchange_strong(node, fresh, std::memory_order_acq_rel,
+                                                  std::memory_order_acquire)) {
+                owned = true;
+                return fresh;
+            }
+            // Lost the slot: `node` is the winner's entry, maybe for this key
+        }
+        if (node->hash == hash && node->key == key) {
+            discard();
+            return node;
+        }
+    }
+    discard();
+    return nullptr;
+}
+
+bool ConcurrentRatingCache::reclaim(Node* node) {
+    int expected = FAILED;
+    return node->state.compare_exchange_strong(expected, PENDING, std::memory_order_acq_rel);
+}
+
+void ConcurrentRatingCache::settle(Node* node, State state) {
+    node->state.store(state, std::memory_order_release);
+    // Taking the lock orders the store before any waiter's predicate check
+    { std::lock_guard<std::mutex> lock(wait_mutex_); }
+    settled_.notify_all();
+}
+
+void ConcurrentRatingCache::wait_settled(const Node* node) {
+    waits_.fetch_add(1, std::memory_order_relaxed);
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    settled_.wait(lock, [&] { return node->state.load(std::memory_order_acquire) != PENDING; });
+}
+
+bool ConcurrentRatingCache::find(const Key& key, Rating& out) const {
+    const Node* node = lookup(key, hash_key(key));
+    if (!node || node->state.load(std::memory_order_acquire) != READY) return false;
+    out = node->rating;
+    hits_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+ConcurrentRatingCache::Rating ConcurrentRatingCache::get(const Key& key, const Fetch& fetch) {
+    const uint64_t hash = hash_key(key);
+    if (const Node* node = lookup(key, hash)) {
+        if (node->state.load(std::memory_order_acquire) == READY) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return node->rating;
+        }
+    }
+
+    bool owned = false;
+    Node* node = lookup_or_claim(key, hash, owned);
+    if (!node) {
+        uncached_.fetch_add(1, std::memory_order_relaxed);
+        fetches_.fetch_add(1, std::memory_order_relaxed);
+        return fetch();
+    }
+    while (!owned) {
+        int state = node->state.load(std::memory_order_acquire);
+        if (state == READY) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return node->rating;
+        }
+        if (state == FAILED) owned = reclaim(node);
+        else wait_settled(node);
+    }
+
+    fetches_.fetch_add(1, std::memory_order_relaxed);
+    try {
+        node->rating = fetch();
+    } catch (...) {
+        settle(node, FAILED);
+        throw;
+    }
+    settle(node, READY);
+    return node->rating;
+}
+
+bool ConcurrentRatingCache::get_many(const std::vector<Key>& keys, std::vector<Rating>& out,
+                                     const FetchMany& fetch) {
+    out.assign(keys.size(), Rating{});
+
+    /* 1. take what is ready, claim what nobody is fetching yet */
+    std::vector<Node*> nodes(keys.size(), nullptr);
+    std::vector<size_t> mine;     // fetched by this call (claimed, or uncached)
+    std::vector<size_t> theirs;   // being fetched by another thread
+    for (size_t i = 0; i < keys.size(); ++i) {
+        bool owned = false;
+        Node* node = lookup_or_claim(keys[i], hash_key(keys[i]), owned);
+        nodes[i] = node;
+        if (!node) {
+            uncached_.fetch_add(1, std::memory_order_relaxed);
+            mine.push_back(i);
+            continue;
+        }
+        int state = owned ? PENDING : node->state.load(std::memory_order_acquire);
+        if (state == READY) {
+            out[i] = node->rating;
+            hits_.fetch_add(1, std::memory_order_relaxed);
+        } else if (owned || (state == FAILED && reclaim(node))) {
+            mine.push_back(i);
+        } else {
+            theirs.push_back(i);
+        }
+    }
+
+    /* 2. one fetch for this call's share, published before waiting on the
+          rest (a key listed twice waits on this very fetch) */
+    if (!mine.empty()) {
+        std::vector<Key> batch;
+        batch.reserve(mine.size());
+        for (size_t i : mine) batch.push_back(keys[i]);
+        std::vector<Rating> found;
+        bool ok = false;
+        fetches_.fetch_add(mine.size(), std::memory_order_relaxed);
+        try {
+            ok = fetch(batch, found) && found.size() == batch.size();
+        } catch (...) {
+            for (size_t i : mine) if (nodes[i]) settle(nodes[i], FAILED);
+            throw;
+        }
+        for (size_t k = 0; k < mine.size(); ++k) {
+            Node* node = nodes[mine[k]];
+            if (ok) {
+                out[mine[k]] = found[k];
+                if (node) node->rating = found[k];
+            }
+            if (node) settle(node, ok ? READY : FAILED);
+        }
+        if (!ok) return false;
+    }
+
+    /* 3. the keys other threads were fetching */
+    bool ok = true;
+    for (size_t i : theirs) {
+        wait_settled(nodes[i]);
+        if (nodes[i]->state.load(std::memory_order_acquire) == READY) {
+            out[i] = nodes[i]->rating;
+            hits_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+ConcurrentRatingCache::Stats ConcurrentRatingCache::stats() const {
+    Stats s;
+    s.hits = hits_.load(std::memory_order_relaxed);
+    s.fetches = fetches_.load(std::memory_order_relaxed);
+    s.waits = waits_.load(std::memory_order_relaxed);
+    s.uncached = uncached_.load(std::memory_order_relaxed);
+    return s;
+}
+
+SharedRatingsCatalog::SharedRatingsCatalog(std::shared_ptr<CatalogSource> source,
+                                           std::shared_ptr<ConcurrentRatingCache> cache)
+    : source_(std::move(source)), cache_(std::move(cache)) {}
+
+std::vector<std::vector<Section>> SharedRatingsCatalog::find_sections_for_class(const std::string& class_code) {
+    return source_->find_sections_for_class(class_code);
+}
+
+std::map<std::string, std::vector<std::vector<Section>>> SharedRatingsCatalog::find_sections_for_classes(
+    const std::vector<std::string>& class_codes) {
+    return source_->find_sections_for_classes(class_codes);
+}
+
+std::set<std::string> SharedRatingsCatalog::get_required_section_types(const std::string& class_code) const {
+    return source_->get_required_section_types(class_code);
+}
+
+CatalogSource::ProfessorRating SharedRatingsCatalog::get_professor_ratings(
+    const std::string& professor_name, const std::string& class_code) {
+    ConcurrentRatingCache::Key key = rating_key(professor_name, class_code);
+    return cache_->get(key, [&] { return source_->get_professor_ratings(key.first, key.second); });
+}
+
+bool SharedRatingsCatalog::get_professor_ratings_bulk(
+    const std::vector<std::pair<std::string, std::string>>& lookups,
+    std::vector<ProfessorRating>& out) {
+    std::vector<ConcurrentRatingCache::Key> keys;
+    keys.reserve(lookups.size());
+    for (const auto& [name, code] : lookups) keys.push_back(rating_key(name, code));
+    return cache_->get_many(keys, out, [&](const std::vector<ConcurrentRatingCache::Key>& batch,
+                                           std::vector<ProfessorRating>& found) {
+        return source_->get_professor_ratings_bulk(batch, found);
+    });
+}
+
+std::shared_ptr<CatalogSource> SharedRatingsCatalog::open_another() {
+    auto other = source_->open_another();
+    if (other == source_) return shared_from_this();
+    return std::make_shared<SharedRatingsCatalog>(std::move(other), cache_);
+}
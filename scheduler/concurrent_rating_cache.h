@@ -0,0 +1,126 @@
+// concurrent_rating_cache.h
+#pragma once
+#include "catalog_source.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Professor ratings shared by every thread of the process. An open-addressing
+// table of atomic slots: a lookup is one hash and one key compare on atomic
+// loads, so readers never block. A miss inserts a pending entry with a
+// single compare-and-swap; the thread that wins it fetches the rating and
+// every other thread asking for the same key meanwhile waits for that one
+// fetch instead of making its own. Entries are never removed and the table
+// never grows; once max_entries are in, further keys are fetched uncached.
+class ConcurrentRatingCache {
+public:
+    using Key = std::pair<std::string, std::string>;   // (instructor, class code)
+    using Rating = CatalogSource::ProfessorRating;
+    using Fetch = std::function<Rating()>;
+    // Ratings for `keys` into `out` (same order); false if the fetch failed
+    using FetchMany = std::function<bool(const std::vector<Key>& keys, std::vector<Rating>& out)>;
+
+    struct Stats {
+        size_t hits = 0;       // answered from the table (after waiting, for `waits` of them)
+        size_t fetches = 0;    // keys this cache asked a fetch function for
+        size_t waits = 0;      // times a thread waited for another's fetch of the same key
+        size_t uncached = 0;   // fetches made without an entry because the table was full
+    };
+
+    explicit ConcurrentRatingCache(size_t max_entries = 16384);
+    ~ConcurrentRatingCache();
+    ConcurrentRatingCache(const ConcurrentRatingCache&) = delete;
+    ConcurrentRatingCache& operator=(const ConcurrentRatingCache&) = delete;
+
+    // The cached rating into `out`; false if absent or still being fetched.
+    // Never blocks.
+    bool find(const Key& key, Rating& out) const;
+
+    // The rating for `key`: from the table, from `fetch` on this thread, or
+    // from another thread's fetch of the same key once it lands. If a fetch
+    // throws, the exception reaches its caller and the next get() retries.
+    Rating get(const Key& key, const Fetch& fetch);
+
+    // get() for many keys: the ones no other thread is fetching go to one
+    // `fetch` call, then the call waits for the rest. False if any fetch
+    // failed; `out` is then incomplete and get() per key is the fallback.
+    bool get_many(const std::vector<Key>& keys, std::vector<Rating>& out, const FetchMany& fetch);
+
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+    size_t max_entries() const { return max_entries_; }
+    Stats stats() const;
+
+private:
+    enum State : int { PENDING, READY, FAILED };
+
+    struct Node {
+        Node(uint64_t hash, const Key& key) : hash(hash), key(key) {}
+        const uint64_t hash;
+        const Key key;
+        std::atomic<int> state{PENDING};
+        Rating rating;   // written by the fetching thread only, read once READY
+    };
+
+    std::unique_ptr<std::atomic<Node*>[]> slots_;
+    size_t mask_;
+    size_t max_entries_;
+    std::atomic<size_t> size_{0};
+
+    // Only threads waiting on another thread's fetch ever take this
+    mutable std::mutex wait_mutex_;
+    std::condition_variable settled_;
+
+    mutable std::atomic<size_t> hits_{0};
+    std::atomic<size_t> fetches_{0};
+    std::atomic<size_t> waits_{0};
+    std::atomic<size_t> uncached_{0};
+
+    static uint64_t hash_key(const Key& key);
+    const Node* lookup(const Key& key, uint64_t hash) const;
+    // The entry for `key`, inserting a PENDING one owned by the caller
+    // (owned = true) if there is none; null if the table is full
+    Node* lookup_or_claim(const Key& key, uint64_t hash, bool& owned);
+    // Take over a FAILED entry for a new fetch
+    static bool reclaim(Node* node);
+    void settle(Node* node, State state);
+    void wait_settled(const Node* node);
+};
+
+// CatalogSource that answers professor ratings through a ConcurrentRatingCache
+// and passes everything else to the source it wraps. The sources its
+// open_another() hands out (e.g. to a ConnectionPool) wrap new connections
+// but share the cache, so every thread of the process fetches a given
+// instructor and class at most once. Meant for processes that run several
+// Schedulers at once, each RatingCache having a single owner; the CLI runs
+// one request and reads its ratings through that Scheduler's RatingCache.
+class SharedRatingsCatalog : public CatalogSource {
+public:
+    explicit SharedRatingsCatalog(std::shared_ptr<CatalogSource> source,
+                                  std::shared_ptr<ConcurrentRatingCache> cache =
+                                      std::make_shared<ConcurrentRatingCache>());
+
+    const std::shared_ptr<ConcurrentRatingCache>& rating_cache() const { return cache_; }
+
+    std::vector<std::vector<Section>> find_sections_for_class(const std::string& class_code) override;
+    std::map<std::string, std::vector<std::vector<Section>>> find_sections_for_classes(
+        const std::vector<std::string>& class_codes) override;
+    std::set<std::string> get_required_section_types(const std::string& class_code) const override;
+    ProfessorRating get_professor_ratings(const std::string& professor_name,
+                                          const std::string& class_code) override;
+    bool get_professor_ratings_bulk(const std::vector<std::pair<std::string, std::string>>& lookups,
+                                    std::vector<ProfessorRating>& out) override;
+    bool is_connected() const override { return source_->is_connected(); }
+    std::string source_id() const override { return source_->source_id(); }
+    std::shared_ptr<CatalogSource> open_another() override;
+
+private:
+    std::shared_ptr<CatalogSource> source_;
+    std::shared_ptr<ConcurrentRatingCache> cache_;
+};
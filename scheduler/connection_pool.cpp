@@ -0,0 +1,68 @@
+// connection_pool.cpp
+#include "connection_pool.h"
+#include <algorithm>
+
+ConnectionPool::ConnectionPool(std::shared_ptr<CatalogSource> like, size_t max_size, bool lend_like)
+    : like_(std::move(like)), max_size_(std::max<size_t>(1, max_size)) {
+    if (lend_like) {
+        idle_.push_back(like_);
+        open_ = 1;
+    }
+}
+
+ConnectionPool::Lease ConnectionPool::acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    returned_.wait(lock, [&] { return !idle_.empty() || open_ < max_size_; });
+    if (!idle_.empty()) {
+        auto conn = std::move(idle_.back());
+        idle_.pop_back();
+        return Lease(this, std::move(conn));
+    }
+
+    // Claim the slot, then connect without holding the lock
+    ++open_;
+    lock.unlock();
+    try {
+        auto conn = like_->open_another();
+        return Lease(this, std::move(conn));
+    } catch (...) {
+        lock.lock();
+        --open_;
+        returned_.notify_one();
+        throw;
+    }
+}
+
+size_t ConnectionPool::open_connections() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return open_;
+}
+
+void ConnectionPool::release(std::shared_ptr<CatalogSource> conn) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // A connection that dropped is closed rather than lent out again
+    if (conn->is_connected()) idle_.push_back(std::move(conn));
+    else --open_;
+    returned_.notify_one();
+}
+
+ConnectionPool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), conn_(std::move(other.conn_)) {
+    other.pool_ = nullptr;
+}
+
+ConnectionPool::Lease& ConnectionPool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        reset();
+        pool_ = other.pool_;
+        conn_ = std::move(other.conn_);
+        other.pool_ = nullptr;
+    }
+    return *this;
+}
+
+void ConnectionPool::Lease::reset() {
+    if (pool_ && conn_) pool_->release(std::move(conn_));
+    pool_ = nullptr;
+    conn_.reset();
+}
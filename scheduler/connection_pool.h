@@ -0,0 +1,65 @@
+// connection_pool.h
+#pragma once
+#include "catalog_source.h"
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Bounded set of connections to one catalog source (see
+// CatalogSource::open_another), shared by every request instead of each
+// thread connecting on its own. Connections are opened on first demand and
+// kept; once max_size() are lent out, acquire() waits until one is handed back.
+// A pool can also lend the source it was made from, so a caller that only
+// ever needs one connection at a time never opens a second.
+class ConnectionPool {
+public:
+    // A borrowed connection, returned to the pool when the lease goes away.
+    // The pool must outlive its leases.
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() { reset(); }
+
+        const std::shared_ptr<CatalogSource>& connection() const { return conn_; }
+        CatalogSource* operator->() const { return conn_.get(); }
+        explicit operator bool() const { return conn_ != nullptr; }
+
+        void reset();   // hand the connection back now
+
+    private:
+        friend class ConnectionPool;
+        Lease(ConnectionPool* pool, std::shared_ptr<CatalogSource> conn)
+            : pool_(pool), conn_(std::move(conn)) {}
+
+        ConnectionPool* pool_ = nullptr;
+        std::shared_ptr<CatalogSource> conn_;
+    };
+
+    // New connections come from like->open_another(). With lend_like, `like`
+    // itself is the first connection lent out (and counts toward max_size);
+    // its owner must then only use it directly while no lease holds it.
+    ConnectionPool(std::shared_ptr<CatalogSource> like, size_t max_size, bool lend_like = false);
+
+    Lease acquire();
+
+    size_t max_size() const { return max_size_; }
+    size_t open_connections() const;
+
+private:
+    void release(std::shared_ptr<CatalogSource> conn);
+
+    std::shared_ptr<CatalogSource> like_;
+    size_t max_size_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable returned_;
+    std::vector<std::shared_ptr<CatalogSource>> idle_;
+    size_t open_ = 0;   // idle + lent out + being opened
+};
@@ -0,0 +1,466 @@
+#include "course_catalog.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Pull parser over an in-memory JSON text: values are read or skipped as
+// the caller walks the document, nothing is kept beyond what it asks for
+class JsonReader {
+public:
+    JsonReader(const char* data, size_t size) : pos_(data), begin_(data), end_(data + size) {}
+
+    // Calls on_member(key) for every member; on_member must consume the value
+    template <typename F>
+    void object(F&& on_member) {
+        expect('{');
+        if (consume('}')) return;
+        std::string key;
+        do {
+            read_string(key);
+            expect(':');
+            on_member(key);
+        } while (consume(','));
+        expect('}');
+    }
+
+    // Calls on_element() for every element; it must consume the value
+    template <typename F>
+    void array(F&& on_element) {
+        expect('[');
+        if (consume(']')) return;
+        do {
+            on_element();
+        } while (consume(','));
+        expect(']');
+    }
+
+    bool null() {
+        skip_space();
+        if (end_ - pos_ >= 4 && std::equal(pos_, pos_ + 4, "null")) {
+            pos_ += 4;
+            return true;
+        }
+        return false;
+    }
+
+    void read_string(std::string& out) {
+        expect('"');
+        out.clear();
+        while (true) {
+            const char* run = pos_;
+            while (pos_ < end_ && *pos_ != '"' && *pos_ != '\\') ++pos_;
+            out.append(run, pos_);
+            if (pos_ >= end_) fail("unterminated string");
+            if (*pos_++ == '"') return;
+            if (pos_ >= end_) fail("unterminated escape");
+            char c = *pos_++;
+            switch (c) {
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': append_utf8(out, read_code_point()); break;
+                default:  out += c; break;   // \" \\ \/
+            }
+        }
+    }
+
+    // A string, or "" for null
+    std::string string_or_empty() {
+        std::string out;
+        if (!null()) read_string(out);
+        return out;
+    }
+
+    // Integer value (fractions truncated); 0 for null
+    int integer() {
+        skip_space();
+        if (null()) return 0;
+        const char* start = pos_;
+        while (pos_ < end_ && (std::isdigit(static_cast<unsigned char>(*pos_)) ||
+                               *pos_ == '-' || *pos_ == '+' || *pos_ == '.' || *pos_ == 'e' || *pos_ == 'E')) {
+            ++pos_;
+        }
+        if (start == pos_) fail("expected a number");
+        return static_cast<int>(std::strtod(std::string(start, pos_).c_str(), nullptr));
+    }
+
+    void skip_value() {
+        skip_space();
+        if (pos_ >= end_) fail("unexpected end of input");
+        switch (*pos_) {
+            case '{': object([&](const std::string&) { skip_value(); }); return;
+            case '[': array([&] { skip_value(); }); return;
+            case '"': {
+                std::string ignored;
+                read_string(ignored);
+                return;
+            }
+            default:
+                while (pos_ < end_ && *pos_ != ',' && *pos_ != '}' && *pos_ != ']' &&
+                       !std::isspace(static_cast<unsigned char>(*pos_))) {
+                    ++pos_;
+                }
+        }
+    }
+
+    bool peek(char c) {
+        skip_space();
+        return pos_ < end_ && *pos_ == c;
+    }
+
+    void finish() {
+        skip_space();
+        if (pos_ != end_) fail("trailing characters");
+    }
+
+private:
+    const char* pos_;
+    const char* begin_;
+    const char* end_;
+
+    void skip_space() {
+        while (pos_ < end_ && (*pos_ == ' ' || *pos_ == '\n' || *pos_ == '\r' || *pos_ == '\t')) ++pos_;
+    }
+
+    bool consume(char c) {
+        if (!peek(c)) return false;
+        ++pos_;
+        return true;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) fail(std::string("expected '") + c + "'");
+    }
+
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("Catalog JSON: " + what + " at offset " + std::to_string(pos_ - begin_));
+    }
+
+    unsigned hex4() {
+        if (end_ - pos_ < 4) fail("short \\u escape");
+        unsigned value = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = *pos_++;
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= c - '0';
+            else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+            else fail("bad \\u escape");
+        }
+        return value;
+    }
+
+    unsigned read_code_point() {
+        unsigned cp = hex4();
+        if (cp >= 0xD800 && cp < 0xDC00 && end_ - pos_ >= 6 && pos_[0] == '\\' && pos_[1] == 'u') {
+            pos_ += 2;
+            unsigned low = hex4();
+            if (low >= 0xDC00 && low < 0xE000) return 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            fail("unpaired surrogate");
+        }
+        return cp;
+    }
+
+    static void append_utf8(std::string& out, unsigned cp) {
+        if (cp < 0x80) {
+            out += static_cast<char>(cp);
+        } else if (cp < 0x800) {
+            out += static_cast<char>(0xC0 | (cp >> 6));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else if (cp < 0x10000) {
+            out += static_cast<char>(0xE0 | (cp >> 12));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (cp >> 18));
+            out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (cp & 0x3F));
+        }
+    }
+};
+
+std::string trim(const std::string& s) {
+    size_t first = s.find_first_not_of(" \t\r\n\f\v");
+    if (first == std::string::npos) return "";
+    return s.substr(first, s.find_last_not_of(" \t\r\n\f\v") - first + 1);
+}
+
+// Text Postgres prints for a text[] holding `values` (what days_of_week::text
+// and instructors::text come back as): elements quoted only when they need it
+std::string pg_array_text(const std::vector<std::string>& values) {
+    std::string out = "{";
+    for (size_t i = 0; i < values.size(); ++i) {
+        const std::string& v = values[i];
+        if (i > 0) out += ',';
+        std::string upper = v;
+        std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+        bool quote = v.empty() || upper == "NULL" ||
+            v.find_first_of("{}\",\\ \t\n\r\v\f") != std::string::npos;
+        if (!quote) {
+            out += v;
+            continue;
+        }
+        out += '"';
+        for (char c : v) {
+            if (c == '"' || c == '\\') out += '\\';
+            out += c;
+        }
+        out += '"';
+    }
+    return out + "}";
+}
+
+// ingestion/database/load_courses.py parse_schedule(): "Mon, Wed, 2:00-3:20 pm"
+// -> days {Mon,Wed}, "2:00 pm", "3:20 pm". No days at all for "TBA"
+struct Meeting {
+    bool has_days = false;
+    std::vector<std::string> days;
+    std::string start, end;
+};
+
+Meeting parse_schedule(const std::string& schedule) {
+    Meeting m;
+    std::string upper = trim(schedule);
+    std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+    if (upper.empty() || upper == "TBA") return m;
+
+    m.has_days = true;
+    std::string time;
+    size_t comma = schedule.rfind(',');
+    if (comma != std::string::npos) {
+        size_t from = 0;
+        while (true) {
+            size_t next = schedule.find(',', from);
+            if (next >= comma) {
+                m.days.push_back(trim(schedule.substr(from, comma - from)));
+                break;
+            }
+            m.days.push_back(trim(schedule.substr(from, next - from)));
+            from = next + 1;
+        }
+        time = trim(schedule.substr(comma + 1));
+    } else {
+        time = trim(schedule);
+    }
+
+    // One dash only: anything else made the Python loader give up
+    size_t dash = time.find('-');
+    if (dash == std::string::npos || time.find('-', dash + 1) != std::string::npos) return m;
+    m.start = trim(time.substr(0, dash));
+    m.end = trim(time.substr(dash + 1));
+
+    auto meridiem = [](const std::string& s) {
+        size_t am = s.find("am"), pm = s.find("pm");
+        if (am == std::string::npos && pm == std::string::npos) return std::string();
+        return std::string(am < pm ? "am" : "pm");
+    };
+    if (!meridiem(m.end).empty() && meridiem(m.start).empty()) m.start += " " + meridiem(m.end);
+    return m;
+}
+
+// load_courses.py clean_location(): trailing "launch" dropped
+std::string clean_location(std::string location) {
+    static const std::string suffix = "launch";
+    if (location.size() >= suffix.size() &&
+        location.compare(location.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        location.erase(location.size() - suffix.size());
+    }
+    return trim(location);
+}
+
+// First run of 5-6 digits in a file name: usc_20253_courses.json -> 20253
+std::string semester_from_path(const std::string& path) {
+    std::string name = path.substr(path.find_last_of('/') + 1);
+    for (size_t i = 0; i < name.size(); ++i) {
+        size_t j = i;
+        while (j < name.size() && j - i < 6 && std::isdigit(static_cast<unsigned char>(name[j]))) ++j;
+        if (j - i >= 5) return name.substr(i, j - i);
+    }
+    return "";
+}
+
+// A sections row as the loader stores it, before parent links are resolved
+struct SectionRow {
+    std::string type;
+    std::vector<std::string> days;
+    std::pair<std::string, std::string> times;
+    std::string location;
+    int registered = 0;
+    int seats = 0;
+    std::string instructors;
+    std::string number;
+    std::string parent;   // parent_section_number as scraped
+};
+
+// One entry of a class's "sections" array, as the loader would store it and
+// query_sections_from_db would read it back; false for entries the loader skips
+bool read_section(JsonReader& in, std::vector<SectionRow>& out) {
+    std::string number, type, schedule, location, parent;
+    std::vector<std::string> instructors;
+    bool has_number = false, has_type = false, has_units = false;
+    int registered = 0, seats = 0;
+
+    in.object([&](const std::string& key) {
+        if (key == "sectionNumber" && in.peek('"')) {
+            in.read_string(number);
+            has_number = true;
+        } else if (key == "type" && in.peek('"')) {
+            in.read_string(type);
+            has_type = true;
+        } else if (key == "units") {
+            has_units = !in.null();
+            if (has_units) in.skip_value();
+        } else if (key == "parent_section_number") {
+            parent = in.string_or_empty();
+        } else if (key == "schedule") {
+            schedule = in.string_or_empty();
+        } else if (key == "location") {
+            location = in.string_or_empty();
+        } else if (key == "instructors") {
+            if (in.null()) return;
+            in.array([&] { instructors.push_back(in.string_or_empty()); });
+        } else if (key == "registered") {
+            if (in.null()) return;
+            in.object([&](const std::string& field) {
+                if (field == "current") registered = in.integer();
+                else if (field == "capacity") seats = in.integer();
+                else in.skip_value();
+            });
+        } else {
+            in.skip_value();
+        }
+    });
+    if (!has_number || !has_type || !has_units) return false;
+
+    Meeting meeting = parse_schedule(schedule);
+    std::vector<std::string> meeting_days;
+    if (meeting.has_days) {
+        // Split like the database path splits days_of_week::text
+        std::string days = pg_array_text(meeting.days);
+        size_t at = 0;
+        while ((at = days.find_first_not_of(" \t\n\r\f\v", at)) != std::string::npos) {
+            size_t stop = days.find_first_of(" \t\n\r\f\v", at);
+            meeting_days.push_back(days.substr(at, stop - at));
+            at = stop;
+        }
+    }
+
+    // Re-scraped sections replace the earlier copy (ON CONFLICT ... DO UPDATE)
+    SectionRow row{std::move(type), std::move(meeting_days),
+                   std::make_pair(std::move(meeting.start), std::move(meeting.end)),
+                   clean_location(std::move(location)), registered, seats,
+                   pg_array_text(instructors), number, std::move(parent)};
+    for (auto& existing : out) {
+        if (existing.number == number) {
+            existing = std::move(row);
+            return true;
+        }
+    }
+    out.push_back(std::move(row));
+    return true;
+}
+
+// The parent links and row order query_sections_from_db reads back: a
+// parent number the class doesn't have links nothing (the loader's
+// subquery finds no row), and rows come ORDER BY section_number, id - by
+// number, then first insertion, which is file order here
+std::vector<Section> sections_like_database(std::vector<SectionRow> rows) {
+    std::set<std::string> numbers;
+    for (const auto& row : rows) numbers.insert(row.number);
+    std::stable_sort(rows.begin(), rows.end(), [](const SectionRow& a, const SectionRow& b) {
+        return a.number < b.number;
+    });
+
+    std::vector<Section> sections;
+    sections.reserve(rows.size());
+    for (auto& row : rows) {
+        if (!numbers.count(row.parent)) row.parent.clear();
+        sections.emplace_back(std::move(row.type), std::move(row.days), std::move(row.times),
+                              std::move(row.location), row.registered, row.seats,
+                              std::move(row.instructors), std::move(row.number), std::move(row.parent));
+    }
+    return sections;
+}
+
+} // namespace
+
+CourseCatalog CourseCatalog::load_json(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) throw std::runtime_error("Cannot open catalog file " + path);
+    std::string data(static_cast<size_t>(file.tellg()), '\0');
+    file.seekg(0);
+    if (!file.read(&data[0], data.size())) throw std::runtime_error("Cannot read catalog file " + path);
+    return parse_json(data.data(), data.size(), semester_from_path(path));
+}
+
+CourseCatalog CourseCatalog::parse_json(const char* data, size_t size, std::string semester) {
+    CourseCatalog catalog;
+    catalog.semester_ = std::move(semester);
+
+    JsonReader in(data, size);
+    in.object([&](const std::string& code) {
+        std::vector<Section>& sections = catalog.classes_[code];
+        catalog.sections_ -= sections.size();   // a repeated code replaces the earlier one
+        std::vector<SectionRow> rows;
+        in.object([&](const std::string& key) {
+            if (key != "sections" || in.null()) {
+                if (key != "sections") in.skip_value();
+                return;
+            }
+            in.array([&] { read_section(in, rows); });
+        });
+        sections = sections_like_database(std::move(rows));
+        catalog.sections_ += sections.size();
+    });
+    in.finish();
+    return catalog;
+}
+
+void CourseCatalog::add_section(const std::string& class_code, Section section) {
+    classes_[class_code].push_back(std::move(section));
+    ++sections_;
+}
+
+std::vector<Section> CourseCatalog::sections_for_class(const std::string& class_code) const {
+    auto it = classes_.find(class_code);
+    return it == classes_.end() ? std::vector<Section>() : it->second;
+}
+
+std::vector<std::vector<Section>> CourseCatalog::find_sections_for_class(
+    const std::string& class_code) const {
+    std::vector<std::vector<Section>> result;
+    auto it = classes_.find(class_code);
+    if (it == classes_.end()) return result;
+
+    // Grouped by type in type order, like DatabaseConnection
+    std::map<std::string, std::vector<Section>> sections_by_type;
+    for (const auto& section : it->second) {
+        sections_by_type[section.get_section_type()].push_back(section);
+    }
+    for (auto& [type, type_sections] : sections_by_type) {
+        result.push_back(std::move(type_sections));
+    }
+    return result;
+}
+
+std::set<std::string> CourseCatalog::get_required_section_types(const std::string& class_code) const {
+    std::set<std::string> required_types;
+    auto it = classes_.find(class_code);
+    if (it != classes_.end()) {
+        for (const auto& section : it->second) {
+            if (!section.get_section_type().empty()) required_types.insert(section.get_section_type());
+        }
+    }
+    // Fallback: always require at least "Lecture" if nothing found
+    if (required_types.empty()) required_types.insert("Lecture");
+    return required_types;
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "section.h"
+
+// One semester's sections held in memory, keyed by class code. Sections come
+// out as DatabaseConnection builds them from the tables the ingestion
+// scripts fill - same fields, parent links and row order (section number) -
+// so either source can feed the scheduler and number packages alike.
+// Section numbers compare bytewise here and under the database's collation
+// there; the two agree on USC's digits-then-letter numbers.
+class CourseCatalog {
+public:
+    CourseCatalog() = default;
+
+    // Parse a scraped semester file (ingestion/app/scraped_data/
+    // usc_<semester>_courses.json) in one streaming pass, no document tree.
+    // The semester comes from the file name. Throws std::runtime_error if
+    // the file can't be read or isn't valid JSON.
+    static CourseCatalog load_json(const std::string& path);
+    static CourseCatalog parse_json(const char* data, size_t size, std::string semester = "");
+
+    // Append a section to a class (created if new), e.g. for synthetic
+    // catalogs; kept in the order added
+    void add_section(const std::string& class_code, Section section);
+
+    // Same shapes as the DatabaseConnection calls of the same name
+    std::vector<Section> sections_for_class(const std::string& class_code) const;
+    std::vector<std::vector<Section>> find_sections_for_class(const std::string& class_code) const;
+    std::set<std::string> get_required_section_types(const std::string& class_code) const;
+
+    bool contains(const std::string& class_code) const { return classes_.count(class_code) > 0; }
+    size_t class_count() const { return classes_.size(); }
+    size_t section_count() const { return sections_; }
+    const std::string& semester() const { return semester_; }
+
+private:
+    std::unordered_map<std::string, std::vector<Section>> classes_;
+    size_t sections_ = 0;
+    std::string semester_;
+};
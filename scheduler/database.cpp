@@ -5,6 +5,133 @@
 #include <algorithm>
 #include <set>
 
+namespace {
+
+// Section columns as query_sections_from_db selects them; every column is
+// cast so its binary wire format is fixed (text: raw bytes, int4: 4 bytes
+// big-endian)
+#define SECTION_COLUMNS \
+    "s.type::text, s.days_of_week::text, s.start_time::text, s.end_time::text, " \
+    "s.location::text, s.num_students_enrolled::int4, s.num_seats::int4, " \
+    "s.instructors::text, s.section_number::text, p.section_number::text "
+
+// Column `col` of a binary-format row (a NULL reads as empty/0)
+std::string text_column(const PGresult* result, int row, int col) {
+    return std::string(PQgetvalue(result, row, col), PQgetlength(result, row, col));
+}
+
+int int4_column(const PGresult* result, int row, int col) {
+    if (PQgetisnull(result, row, col) || PQgetlength(result, row, col) != 4) return 0;
+    auto bytes = reinterpret_cast<const unsigned char*>(PQgetvalue(result, row, col));
+    return static_cast<int32_t>(uint32_t(bytes[0]) << 24 | uint32_t(bytes[1]) << 16 |
+                                uint32_t(bytes[2]) << 8 | uint32_t(bytes[3]));
+}
+
+// Section from SECTION_COLUMNS at [first, first + 10) of a binary-format row
+Section section_from_row(const PGresult* result, int row, int first) {
+    // Meeting days: whitespace-separated words, split in place
+    std::vector<std::string> meeting_days;
+    const char* days = PQgetvalue(result, row, first + 1);
+    const char* days_end = days + PQgetlength(result, row, first + 1);
+    auto is_space = [](char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v'; };
+    while (days != days_end) {
+        const char* word = std::find_if_not(days, days_end, is_space);
+        days = std::find_if(word, days_end, is_space);
+        if (word != days) meeting_days.emplace_back(word, days);
+    }
+
+    return Section(
+        text_column(result, row, first + 0),
+        std::move(meeting_days),
+        std::make_pair(text_column(result, row, first + 2), text_column(result, row, first + 3)),
+        text_column(result, row, first + 4),
+        int4_column(result, row, first + 5),
+        int4_column(result, row, first + 6),
+        text_column(result, row, first + 7),
+        text_column(result, row, first + 8),
+        text_column(result, row, first + 9)
+    );
+}
+
+// The two steps of a professor rating lookup: the course-specific row with
+// the most reviews, else the professor-wide numbers
+const char* const RATING_FOR_COURSE_SQL = R"SQL(
+            SELECT
+                   COALESCE(pcr.avg_quality,0)      ,
+                   COALESCE(pcr.avg_difficulty,0)   ,
+                   COALESCE(p.would_take_again_percent,0),
+                   COALESCE(p.avg_rating,0)         ,
+                   COALESCE(p.avg_difficulty,0)
+            FROM   professors            p
+            JOIN   prof_course_ratings   pcr
+                   ON p.id = pcr.professor_id
+            /* ── canonical compare: strip every non‑alphanumeric char ── */
+            WHERE  lower(regexp_replace(p.name         ,'[^A-Za-z0-9]','','g'))
+                   = lower(regexp_replace($1           ,'[^A-Za-z0-9]','','g'))
+              AND  lower(regexp_replace(pcr.course_code,'[^A-Za-z0-9]','','g'))
+                   = lower(regexp_replace($2           ,'[^A-Za-z0-9]','','g'))
+            ORDER BY pcr.num_reviews DESC
+            LIMIT 1)SQL";
+
+// Same canonical compare, so "Smith" no longer picks up "Goldsmith"; the
+// expression is the one behind professors.name_key, so this answers exactly
+// what the bulk query does, with or without that migration applied
+const char* const RATING_OVERALL_SQL = R"SQL(
+            SELECT avg_rating, avg_difficulty, would_take_again_percent
+            FROM   professors
+            WHERE  lower(regexp_replace(name,'[^A-Za-z0-9]','','g'))
+                   = lower(regexp_replace($1,'[^A-Za-z0-9]','','g'))
+            ORDER BY id
+            LIMIT 1)SQL";
+
+// Fill `r` from a RATING_FOR_COURSE_SQL result; false if it has no row
+bool course_rating_from(const PGresult* res, DatabaseConnection::ProfessorRating& r) {
+    if (PQresultStatus(res) != PGRES_TUPLES_OK || PQntuples(res) != 1) return false;
+    r.course_specific_quality    = std::stod(PQgetvalue(res,0,0));
+    r.course_specific_difficulty = std::stod(PQgetvalue(res,0,1));
+    r.would_take_again           = std::stod(PQgetvalue(res,0,2));
+    r.quality                    = std::stod(PQgetvalue(res,0,3));
+    r.difficulty                 = std::stod(PQgetvalue(res,0,4));
+    return true;
+}
+
+// Fill `r` from a RATING_OVERALL_SQL result (NULLs stay 0)
+void overall_rating_from(const PGresult* res, DatabaseConnection::ProfessorRating& r) {
+    if (PQresultStatus(res) != PGRES_TUPLES_OK || PQntuples(res) != 1) return;
+    if (!PQgetisnull(res,0,0))
+        r.quality    = std::stod(PQgetvalue(res,0,0));
+    if (!PQgetisnull(res,0,1))
+        r.difficulty = std::stod(PQgetvalue(res,0,1));
+    if (!PQgetisnull(res,0,2))
+        r.would_take_again = std::stod(PQgetvalue(res,0,2));
+}
+
+// Instructor name as the rating lookups use it: array quoting stripped
+std::string rating_name(const std::string& professor_name) {
+    std::string name = professor_name;
+    name.erase(std::remove_if(name.begin(), name.end(),
+                              [](char c){return c=='{'||c=='}'||c=='\"';}),
+               name.end());
+    return name;
+}
+
+// Postgres text[] literal: {"a","b"} with quotes and backslashes escaped
+std::string text_array_literal(const std::vector<std::string>& values) {
+    std::string literal = "{";
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) literal += ',';
+        literal += '"';
+        for (char c : values[i]) {
+            if (c == '"' || c == '\\') literal += '\\';
+            literal += c;
+        }
+        literal += '"';
+    }
+    return literal + "}";
+}
+
+} // namespace
+
 DatabaseConnection::DatabaseConnection(std::string db_name, std::string user, 
                                       std::string password, std::string host, 
                                       int port, std::string semester)
@@ -37,6 +164,20 @@ DatabaseConnection::~DatabaseConnection() {
     }
 }
 
+bool DatabaseConnection::is_connected() const {
+    return conn && PQstatus(conn) == CONNECTION_OK;
+}
+
+std::string DatabaseConnection::source_id() const {
+    return "postgres " + host_ + ":" + std::to_string(port_) + "/" + db_name_ + " semester " + semester_;
+}
+
+std::shared_ptr<CatalogSource> DatabaseConnection::open_another() {
+    auto other = std::make_shared<DatabaseConnection>(db_name_, user_, password_, host_, port_, semester_);
+    other->set_prepared_statements(use_prepared_);
+    return other;
+}
+
 void DatabaseConnection::check_connection() const {
     if (!conn || PQstatus(conn) != CONNECTION_OK) {
         throw std::runtime_error("Database connection is not available");
@@ -50,6 +191,61 @@ std::string DatabaseConnection::get_last_error() const {
     return PQerrorMessage(conn);
 }
 
+bool DatabaseConnection::prepare_once(const char* name, const char* sql, int num_params) const {
+    if (!use_prepared_ || failed_.count(name)) return false;
+    if (!prepared_.count(name)) {
+        PGresult* prepared = PQprepare(conn, name, sql, num_params, nullptr);
+        if (PQresultStatus(prepared) == PGRES_COMMAND_OK) {
+            prepared_.insert(name);
+        } else {
+            std::cerr << "Preparing " << name << " failed, running it unprepared from now on: "
+                      << PQerrorMessage(conn) << std::endl;
+            failed_.insert(name);
+        }
+        PQclear(prepared);
+    }
+    return prepared_.count(name) > 0;
+}
+
+PGresult* DatabaseConnection::run_statement(const char* name, const char* sql,
+                                            int num_params, const char* const* values) const {
+    if (prepare_once(name, sql, num_params)) {
+        return PQexecPrepared(conn, name, num_params, values, nullptr, nullptr, 0);
+    }
+    return PQexecParams(conn, sql, num_params, nullptr, values, nullptr, nullptr, 0);
+}
+
+bool DatabaseConnection::stream_statement(const char* name, const char* sql,
+                                          int num_params, const char* const* values,
+                                          const RowHandler& on_row) const {
+    int sent = prepare_once(name, sql, num_params)
+        ? PQsendQueryPrepared(conn, name, num_params, values, nullptr, nullptr, 1)
+        : PQsendQueryParams(conn, sql, num_params, nullptr, values, nullptr, nullptr, 1);
+    if (!sent) {
+        std::cerr << "Query " << name << " failed: " << PQerrorMessage(conn) << std::endl;
+        return false;
+    }
+    if (!PQsetSingleRowMode(conn)) {
+        std::cerr << "Single-row mode unavailable for " << name << ", reading the whole result" << std::endl;
+    }
+
+    // One PGresult per row, then a final empty one; read to the end even
+    // after an error so the connection is ready for the next query
+    bool ok = true;
+    while (PGresult* result = PQgetResult(conn)) {
+        ExecStatusType status = PQresultStatus(result);
+        if (status == PGRES_SINGLE_TUPLE || status == PGRES_TUPLES_OK) {
+            int rows = PQntuples(result);
+            for (int i = 0; ok && i < rows; ++i) on_row(result, i);
+        } else if (ok) {
+            std::cerr << "Query " << name << " failed: " << PQresultErrorMessage(result) << std::endl;
+            ok = false;
+        }
+        PQclear(result);
+    }
+    return ok;
+}
+
 bool DatabaseConnection::execute_query(const std::string& query, 
                                      const std::vector<std::string>& params) {
     check_connection();
@@ -89,78 +285,21 @@ std::vector<Section> DatabaseConnection::query_sections_from_db(const std::strin
     
     check_connection();
     
-    const char* query = "SELECT s.type, s.days_of_week, s.start_time, s.end_time, "
-                       "s.location, s.num_students_enrolled, s.num_seats, "
-                       "s.instructors, s.section_number, p.section_number as parent_section_number "
+    const char* query = "SELECT " SECTION_COLUMNS
                        "FROM sections s "
                        "LEFT JOIN sections p ON s.parent_section_id = p.id "
                        "JOIN courses c ON s.course_id = c.id "
-                       "WHERE c.code = $1 AND c.semester = $2";
-    
-    std::vector<std::string> params = {class_code, semester_};
-    
-    // Convert std::string params to C-style char* array
-    std::vector<const char*> c_params;
-    for (const auto& param : params) {
-        c_params.push_back(param.c_str());
-    }
-    
-    PGresult* result = PQexecParams(
-        conn, 
-        query, 
-        2,  // two parameters
-        nullptr, 
-        c_params.data(),  // Use c_params.data() instead of params.data()
-        nullptr, 
-        nullptr, 
-        0
-    );
+                       "WHERE c.code = $1 AND c.semester = $2 "
+                       // Fixed order: package ids (and so cursors) index these rows
+                       "ORDER BY s.section_number, s.id";
     
-    if (PQresultStatus(result) != PGRES_TUPLES_OK) {
-        std::cerr << "Failed to get sections: " << PQerrorMessage(conn) << std::endl;
-        PQclear(result);
-        return sections;
-    }
-    
-    // Process results
-    int rows = PQntuples(result);
-    for (int i = 0; i < rows; i++) {
-        // Extract fields
-        std::string section_type = PQgetvalue(result, i, 0);
-        std::string meeting_days_str = PQgetvalue(result, i, 1);
-        std::string start_time = PQgetvalue(result, i, 2);
-        std::string end_time = PQgetvalue(result, i, 3);
-        std::string location = PQgetvalue(result, i, 4);
-        int registered = std::stoi(PQgetvalue(result, i, 5));
-        int seats = std::stoi(PQgetvalue(result, i, 6));
-        std::string instructor = PQgetvalue(result, i, 7);
-        std::string section_number = PQgetvalue(result, i, 8);
-        std::string parent_section_number = PQgetisnull(result, i, 9) ? 
-            "" : PQgetvalue(result, i, 9);
-        
-        // Parse meeting days
-        std::vector<std::string> meeting_days;
-        std::istringstream iss(meeting_days_str);
-        std::string day;
-        while (iss >> day) {
-            meeting_days.push_back(day);
-        }
-        
-        // Create section with parent_section_number
-        sections.emplace_back(
-            section_type,
-            meeting_days,
-            std::make_pair(start_time, end_time),
-            location,
-            registered,
-            seats,
-            instructor,
-            section_number,
-            parent_section_number  // Add parent section number
-        );
+    const char* params[2] = { class_code.c_str(), semester_.c_str() };
+    bool ok = stream_statement("sections_for_class", query, 2, params,
+        [&](const PGresult* row, int i) { sections.push_back(section_from_row(row, i, 0)); });
+    if (!ok) {
+        std::cerr << "Failed to get sections for " << class_code << std::endl;
+        sections.clear();
     }
-    
-    PQclear(result);
     return sections;
 }
 
@@ -184,79 +323,75 @@ std::vector<std::vector<Section>> DatabaseConnection::find_sections_for_class(
     return result;
 }
 
+std::map<std::string, std::vector<std::vector<Section>>> DatabaseConnection::find_sections_for_classes(
+    const std::vector<std::string>& class_codes) {
+    
+    std::map<std::string, std::vector<std::vector<Section>>> result;
+    if (class_codes.empty()) return result;
+    
+    check_connection();
+    
+    const char* query = "SELECT c.code::text, " SECTION_COLUMNS
+                       "FROM sections s "
+                       "LEFT JOIN sections p ON s.parent_section_id = p.id "
+                       "JOIN courses c ON s.course_id = c.id "
+                       "WHERE c.code = ANY($1::text[]) AND c.semester = $2 "
+                       // Fixed order: package ids (and so cursors) index these rows
+                       "ORDER BY s.section_number, s.id";
+    
+    std::string codes = text_array_literal(class_codes);
+    const char* params[2] = { codes.c_str(), semester_.c_str() };
+    
+    // Group by class, then by type (lecture, lab, discussion, etc.), as the
+    // rows arrive
+    std::map<std::string, std::map<std::string, std::vector<Section>>> by_class;
+    bool ok = stream_statement("sections_for_classes", query, 2, params,
+        [&](const PGresult* row, int i) {
+            Section section = section_from_row(row, i, 1);
+            by_class[text_column(row, i, 0)][section.get_section_type()].push_back(std::move(section));
+        });
+    if (!ok) {
+        std::cerr << "Failed to get sections" << std::endl;
+        return result;
+    }
+    
+    for (auto& [code, sections_by_type] : by_class) {
+        auto& groups = result[code];
+        for (auto& [type, type_sections] : sections_by_type) {
+            groups.push_back(std::move(type_sections));
+        }
+    }
+    return result;
+}
+
 DatabaseConnection::ProfessorRating DatabaseConnection::get_professor_ratings(
     const std::string& professor_name, const std::string& course_code) {
         
         ProfessorRating r{};                      // all fields start at 0
-         std::string name = professor_name;    
 
         /* strip curls / quotes that sometimes arrive from the section record */
-        name.erase(std::remove_if(name.begin(), name.end(),
-                                [](char c){return c=='{'||c=='}'||c=='\"';}),
-                name.end());
+        std::string name = rating_name(professor_name);
         if (name.empty()) return r;               // nothing to look up
 
         check_connection();
 
         /* 1️⃣  try course‑specific first  ------------------------------------ */
         {
-            const char* qry = R"SQL(
-            SELECT
-                   COALESCE(pcr.avg_quality,0)      ,
-                   COALESCE(pcr.avg_difficulty,0)   ,
-                   COALESCE(p.would_take_again_percent,0),
-                   COALESCE(p.avg_rating,0)         ,
-                   COALESCE(p.avg_difficulty,0)
-            FROM   professors            p
-            JOIN   prof_course_ratings   pcr
-                   ON p.id = pcr.professor_id
-            /* ── canonical compare: strip every non‑alphanumeric char ── */
-            WHERE  lower(regexp_replace(p.name         ,'[^A-Za-z0-9]','','g'))
-                   = lower(regexp_replace($1           ,'[^A-Za-z0-9]','','g'))
-              AND  lower(regexp_replace(pcr.course_code,'[^A-Za-z0-9]','','g'))
-                   = lower(regexp_replace($2           ,'[^A-Za-z0-9]','','g'))
-            ORDER BY pcr.num_reviews DESC
-            LIMIT 1)SQL";
-
             std::string course = course_code;        // no % wild‑cards!
             const char* vals[2] = { name.c_str(), course.c_str() };
 
-            PGresult* res = PQexecParams(conn, qry, 2, nullptr, vals,
-                                         nullptr, nullptr, 0);
-
-            if (PQresultStatus(res)==PGRES_TUPLES_OK && PQntuples(res)==1) {
-                r.course_specific_quality    = std::stod(PQgetvalue(res,0,0));
-                r.course_specific_difficulty = std::stod(PQgetvalue(res,0,1));
-                r.would_take_again           = std::stod(PQgetvalue(res,0,2));
-                r.quality                    = std::stod(PQgetvalue(res,0,3));
-                r.difficulty                 = std::stod(PQgetvalue(res,0,4));
-                PQclear(res);
-                return r;                           // got the best data
-            }
+            PGresult* res = run_statement("rating_for_course", RATING_FOR_COURSE_SQL, 2, vals);
+            bool found = course_rating_from(res, r);
             PQclear(res);
+            if (found) return r;                    // got the best data
         }
 
         /* 2️⃣  fall back to professor‑wide numbers  -------------------------- */
         {
-            const char* qry =
-                "SELECT avg_rating, avg_difficulty, would_take_again_percent "
-                "FROM professors "
-                "WHERE name ILIKE $1 "
-                "LIMIT 1";
-            std::string n = "%" + name + "%";
-            const char* val[1] = { n.c_str() };
-
-            PGresult* res = PQexecParams(conn, qry, 1, nullptr, val,
-                                        nullptr, nullptr, 0);
-
-            if (PQresultStatus(res)==PGRES_TUPLES_OK && PQntuples(res)==1) {
-                if (!PQgetisnull(res,0,0))
-                    r.quality    = std::stod(PQgetvalue(res,0,0));
-                if (!PQgetisnull(res,0,1))
-                    r.difficulty = std::stod(PQgetvalue(res,0,1));
-                if (!PQgetisnull(res,0,2))
-                    r.would_take_again = std::stod(PQgetvalue(res,0,2));
-            }
+            const char* val[1] = { name.c_str() };
+
+            PGresult* res = run_statement("rating_overall", RATING_OVERALL_SQL, 1, val);
+            overall_rating_from(res, r);
             PQclear(res);
         }
 
@@ -405,6 +540,222 @@ DatabaseConnection::ProfessorRating DatabaseConnection::get_professor_ratings(
     // return ratings;
 }
 
+bool DatabaseConnection::get_professor_ratings_bulk(
+    const std::vector<std::pair<std::string, std::string>>& lookups,
+    std::vector<ProfessorRating>& out) {
+    if (!keyed_ratings_) return get_professor_ratings_pipelined(lookups, out);
+    out.assign(lookups.size(), ProfessorRating{});
+    if (lookups.empty()) return true;
+    check_connection();
+
+    // Per pair: the course-specific row with the most reviews, else the
+    // professor-wide numbers - the same two steps and the same matching as
+    // get_professor_ratings, on the stored keys instead of per-row regexps
+    const char* query = R"SQL(
+        WITH req AS (
+            SELECT ord,
+                   lower(regexp_replace(name  ,'[^A-Za-z0-9]','','g')) AS name_key,
+                   lower(regexp_replace(course,'[^A-Za-z0-9]','','g')) AS course_key
+            FROM   unnest($1::text[], $2::text[]) WITH ORDINALITY AS r(name, course, ord)
+        )
+        SELECT req.ord,
+               c.found IS NOT NULL,
+               COALESCE(c.avg_quality,0), COALESCE(c.avg_difficulty,0),
+               COALESCE(c.would_take_again_percent,0), COALESCE(c.avg_rating,0),
+               COALESCE(c.prof_difficulty,0),
+               p.avg_rating, p.avg_difficulty, p.would_take_again_percent
+        FROM   req
+        LEFT JOIN LATERAL (
+            SELECT TRUE AS found, pcr.avg_quality, pcr.avg_difficulty,
+                   p2.would_take_again_percent, p2.avg_rating,
+                   p2.avg_difficulty AS prof_difficulty
+            FROM   professors p2
+            JOIN   prof_course_ratings pcr ON pcr.professor_id = p2.id
+            WHERE  p2.name_key = req.name_key AND pcr.course_key = req.course_key
+            ORDER BY pcr.num_reviews DESC
+            LIMIT 1) c ON TRUE
+        LEFT JOIN LATERAL (
+            SELECT avg_rating, avg_difficulty, would_take_again_percent
+            FROM   professors
+            WHERE  name_key = req.name_key
+            ORDER BY id
+            LIMIT 1) p ON TRUE)SQL";
+
+    // Same cleanup as get_professor_ratings; a name left empty keeps zeros
+    std::vector<std::string> names, courses;
+    for (const auto& [name, course] : lookups) {
+        std::string n = name;
+        n.erase(std::remove_if(n.begin(), n.end(),
+                               [](char c){return c=='{'||c=='}'||c=='\"';}),
+                n.end());
+        names.push_back(n);
+        courses.push_back(course);
+    }
+    std::string names_param = text_array_literal(names);
+    std::string courses_param = text_array_literal(courses);
+    const char* params[2] = { names_param.c_str(), courses_param.c_str() };
+
+    PGresult* res = run_statement("ratings_bulk", query, 2, params);
+    if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+        std::cerr << "Bulk rating lookup failed, pipelining single lookups instead: "
+                  << PQerrorMessage(conn) << std::endl;
+        PQclear(res);
+        keyed_ratings_ = false;
+        return get_professor_ratings_pipelined(lookups, out);
+    }
+
+    auto number = [&](int row, int col) {
+        return PQgetisnull(res, row, col) ? 0.0 : std::stod(PQgetvalue(res, row, col));
+    };
+    int rows = PQntuples(res);
+    for (int i = 0; i < rows; ++i) {
+        size_t at = std::stoul(PQgetvalue(res, i, 0)) - 1;   // ordinality is 1-based
+        if (at >= out.size()) continue;
+        if (names[at].empty()) continue;
+        ProfessorRating& r = out[at];
+        if (std::string(PQgetvalue(res, i, 1)) == "t") {
+            r.course_specific_quality    = number(i, 2);
+            r.course_specific_difficulty = number(i, 3);
+            r.would_take_again           = number(i, 4);
+            r.quality                    = number(i, 5);
+            r.difficulty                 = number(i, 6);
+        } else {
+            r.quality          = number(i, 7);
+            r.difficulty       = number(i, 8);
+            r.would_take_again = number(i, 9);
+        }
+    }
+    PQclear(res);
+    return true;
+}
+
+bool DatabaseConnection::get_professor_ratings_pipelined(
+    const std::vector<std::pair<std::string, std::string>>& lookups,
+    std::vector<ProfessorRating>& out) {
+    out.assign(lookups.size(), ProfessorRating{});
+    check_connection();
+
+    /* 1️⃣  course-specific rows for every pair with a name */
+    std::vector<size_t> asked;
+    std::vector<std::vector<std::string>> params;
+    for (size_t i = 0; i < lookups.size(); ++i) {
+        std::string name = rating_name(lookups[i].first);
+        if (name.empty()) continue;
+        asked.push_back(i);
+        params.push_back({name, lookups[i].second});
+    }
+    std::vector<bool> found(lookups.size(), false);
+    bool ok = run_pipelined("rating_for_course", RATING_FOR_COURSE_SQL, 2, params,
+        [&](size_t k, const PGresult* res) { found[asked[k]] = course_rating_from(res, out[asked[k]]); });
+
+    /* 2️⃣  professor-wide numbers for the rest */
+    std::vector<size_t> fallback;
+    params.clear();
+    for (size_t i : asked) {
+        if (found[i]) continue;
+        fallback.push_back(i);
+        params.push_back({rating_name(lookups[i].first)});
+    }
+    ok = run_pipelined("rating_overall", RATING_OVERALL_SQL, 1, params,
+        [&](size_t k, const PGresult* res) { overall_rating_from(res, out[fallback[k]]); }) && ok;
+    return ok;
+}
+
+bool DatabaseConnection::run_pipelined(const char* name, const char* sql, int num_params,
+                                       const std::vector<std::vector<std::string>>& param_sets,
+                                       const std::function<void(size_t, const PGresult*)>& on_result) {
+    if (param_sets.empty()) return true;
+    bool prepared = prepare_once(name, sql, num_params);
+    if (!PQenterPipelineMode(conn)) {
+        std::cerr << "Pipeline mode unavailable: " << PQerrorMessage(conn) << std::endl;
+        return false;
+    }
+
+    // Bounded batches keep both directions' socket buffers from filling up
+    // while the other side waits (blocking mode)
+    const size_t BATCH = 64;
+    bool ok = true;
+    bool settled = true;   // every queued statement read back, up to its sync
+    for (size_t first = 0; first < param_sets.size(); first += BATCH) {
+        size_t last = std::min(param_sets.size(), first + BATCH);
+        size_t sent = first;
+        for (; sent < last; ++sent) {
+            std::vector<const char*> values;
+            for (const auto& value : param_sets[sent]) values.push_back(value.c_str());
+            int queued = prepared
+                ? PQsendQueryPrepared(conn, name, num_params, values.data(), nullptr, nullptr, 0)
+                : PQsendQueryParams(conn, sql, num_params, nullptr, values.data(), nullptr, nullptr, 0);
+            if (!queued) {
+                std::cerr << "Queueing " << name << " failed: " << PQerrorMessage(conn) << std::endl;
+                ok = false;
+                break;
+            }
+        }
+        if (!PQpipelineSync(conn)) {
+            // Statements of this batch may be queued with no sync to read them up to
+            std::cerr << "Pipeline sync failed: " << PQerrorMessage(conn) << std::endl;
+            ok = false;
+            settled = false;
+            break;
+        }
+
+        // One result (then a NULL) per statement, then the sync marker;
+        // after an error the rest of the batch comes back aborted. A NULL
+        // where a result belongs (e.g. the connection dropped) ends the
+        // batch: reading on would hand statement i+1's result to i.
+        for (size_t i = first; i < sent; ++i) {
+            PGresult* res = PQgetResult(conn);
+            if (!res) {
+                std::cerr << "Pipelined " << name << " lost its result: "
+                          << PQerrorMessage(conn) << std::endl;
+                ok = false;
+                settled = false;
+                break;
+            }
+            ExecStatusType status = PQresultStatus(res);
+            if (status == PGRES_TUPLES_OK) {
+                on_result(i, res);
+            } else if (ok) {
+                std::cerr << "Pipelined " << name << " failed: "
+                          << PQresultErrorMessage(res) << std::endl;
+                ok = false;
+            }
+            PQclear(res);
+            while (PGresult* extra = PQgetResult(conn)) PQclear(extra);
+        }
+        if (!settled) break;
+
+        // Up to the sync marker; two NULLs in a row mean it is never coming
+        int nulls = 0;
+        while (nulls < 2) {
+            PGresult* res = PQgetResult(conn);
+            if (!res) { ++nulls; continue; }
+            nulls = 0;
+            ExecStatusType status = PQresultStatus(res);
+            PQclear(res);
+            if (status == PGRES_PIPELINE_SYNC) break;
+            ok = false;
+        }
+        if (nulls == 2) {
+            ok = false;
+            settled = false;
+        }
+        if (!ok) break;
+    }
+
+    // A pooled connection must come back out of pipeline mode with nothing
+    // pending, or the next ordinary query on it fails; reset it otherwise
+    if (!settled || !PQexitPipelineMode(conn)) {
+        std::cerr << "Leaving pipeline mode failed, resetting the connection: "
+                  << PQerrorMessage(conn) << std::endl;
+        PQreset(conn);
+        if (PQpipelineStatus(conn) != PQ_PIPELINE_OFF) PQexitPipelineMode(conn);
+        prepared_.clear();   // statements die with the old session
+        ok = false;
+    }
+    return ok;
+}
+
 DatabaseConnection::AllSpots DatabaseConnection::find_class_spots(
     const std::vector<std::vector<std::string>>& class_codes) {
     
@@ -448,25 +799,13 @@ std::set<std::string> DatabaseConnection::get_required_section_types(const std::
     check_connection();
 
     // Query all unique section types for this course in the current semester
-    std::string query =
+    const char* query =
         "SELECT DISTINCT type FROM sections s "
         "JOIN courses c ON s.course_id = c.id "
         "WHERE c.code = $1 AND c.semester = $2";
 
-    std::vector<std::string> params = {class_code, semester_};
-    std::vector<const char*> c_params;
-    for (const auto& param : params) c_params.push_back(param.c_str());
-
-    PGresult* result = PQexecParams(
-        conn,
-        query.c_str(),
-        2,
-        nullptr,
-        c_params.data(),
-        nullptr,
-        nullptr,
-        0
-    );
+    const char* params[2] = { class_code.c_str(), semester_.c_str() };
+    PGresult* result = run_statement("section_types", query, 2, params);
 
     if (PQresultStatus(result) == PGRES_TUPLES_OK) {
         int rows = PQntuples(result);
@@ -1,38 +1,53 @@
 #pragma once
+#include <functional>
 #include <vector>
 #include <string>
 #include <map>
 #include <memory>
 #include <set>
+#include "catalog_source.h"
 #include "section.h"
 
 // Forward declaration for PGconn from libpq
 typedef struct pg_conn PGconn;
+typedef struct pg_result PGresult;
 
-class DatabaseConnection {
+// CatalogSource backed by the Postgres tables the ingestion scripts fill
+class DatabaseConnection : public CatalogSource {
 public:
     DatabaseConnection(std::string db_name, std::string user, std::string password, 
                        std::string host, int port, std::string semester = "");
-    ~DatabaseConnection();
+    ~DatabaseConnection() override;
     
     // Disable copy to prevent issues with connection ownership
     DatabaseConnection(const DatabaseConnection&) = delete;
     DatabaseConnection& operator=(const DatabaseConnection&) = delete;
     
     // Core database functionality
-    std::vector<std::vector<Section>> find_sections_for_class(const std::string& class_code);
+    std::vector<std::vector<Section>> find_sections_for_class(const std::string& class_code) override;
     
-    // Professor ratings
-    struct ProfessorRating {
-        double quality = 0.0;
-        double difficulty = 0.0;
-        double would_take_again = 0.0;
-        double course_specific_quality = 0.0;
-        double course_specific_difficulty = 0.0;
-    };
+    // Sections of every listed class in one round-trip (code = ANY($1)),
+    // grouped per class code and then by type like find_sections_for_class.
+    // Codes without sections are absent from the result.
+    std::map<std::string, std::vector<std::vector<Section>>> find_sections_for_classes(
+        const std::vector<std::string>& class_codes) override;
     
     ProfessorRating get_professor_ratings(const std::string& professor_name, 
-                                         const std::string& class_code);
+                                         const std::string& class_code) override;
+    
+    // Ratings for every (professor, class) pair in one query against the
+    // indexed canonical keys (see server/database/migrations/
+    // add_professor_name_keys.sql); out[i] belongs to lookups[i]. False if
+    // the query failed, e.g. before that migration ran.
+    bool get_professor_ratings_bulk(const std::vector<std::pair<std::string, std::string>>& lookups,
+                                    std::vector<ProfessorRating>& out) override;
+    
+    // Same results as get_professor_ratings for every pair, without the
+    // canonical-key columns: the lookups go out back to back in pipeline
+    // mode, one round-trip per batch instead of per query. What
+    // get_professor_ratings_bulk falls back to.
+    bool get_professor_ratings_pipelined(const std::vector<std::pair<std::string, std::string>>& lookups,
+                                         std::vector<ProfessorRating>& out);
     
     // Schedule building
     using ClassPackage = std::vector<Section>;
@@ -49,8 +64,17 @@ public:
     std::string get_host() const { return host_; }
     int get_port() const { return port_; }
     std::string get_semester() const { return semester_; }
+    bool is_connected() const override;
+    std::string source_id() const override;
+
+    // A new connection with the same settings
+    std::shared_ptr<CatalogSource> open_another() override;
 
-    std::set<std::string> get_required_section_types(const std::string& class_code) const;
+    std::set<std::string> get_required_section_types(const std::string& class_code) const override;
+
+    // The hot queries are prepared once per connection and then executed
+    // by name; off sends the full SQL every call (for comparison and debugging)
+    void set_prepared_statements(bool enabled) { use_prepared_ = enabled; }
 
 private:
     PGconn* conn;
@@ -63,7 +87,35 @@ private:
     std::string host_;
     int port_;
     
+    bool use_prepared_ = true;
+    mutable std::set<std::string> prepared_;   // statement names already prepared on conn
+    mutable std::set<std::string> failed_;     // names whose PQprepare failed: plain PQexecParams from then on
+    bool keyed_ratings_ = true;                // false once the canonical-key query failed here
+    
     // Helper methods
+    // Run a hot query: PQprepare'd as `name` on first use, PQexecPrepared
+    // afterwards; plain PQexecParams if preparing fails or prepared
+    // statements are off. The caller PQclear()s the result.
+    PGresult* run_statement(const char* name, const char* sql,
+                            int num_params, const char* const* values) const;
+    // Same query, results in binary format and handed to `on_row` one row
+    // at a time (PQsetSingleRowMode) while the rest are still arriving; the
+    // PGresult is only valid during the call. False if the query failed.
+    using RowHandler = std::function<void(const PGresult* result, int row)>;
+    bool stream_statement(const char* name, const char* sql, int num_params,
+                          const char* const* values, const RowHandler& on_row) const;
+    // PQprepare `sql` as `name` unless already done; false when prepared
+    // statements are off or preparing failed (tried and logged only once
+    // per name, e.g. behind poolers that reject named statements)
+    bool prepare_once(const char* name, const char* sql, int num_params) const;
+    // Send `sql` once per parameter set in pipeline mode, PQpipelineSync
+    // after every batch, and pass each result to on_result(i, result).
+    // False if pipeline mode is unavailable or any statement failed. The
+    // connection always leaves pipeline mode, through PQreset if results
+    // could not be read back.
+    bool run_pipelined(const char* name, const char* sql, int num_params,
+                       const std::vector<std::vector<std::string>>& param_sets,
+                       const std::function<void(size_t, const PGresult*)>& on_result);
     std::vector<Section> query_sections_from_db(const std::string& class_code);
     bool execute_query(const std::string& query, const std::vector<std::string>& params = {});
     
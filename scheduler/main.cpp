@@ -1,4 +1,6 @@
 #include "scheduler.h"
+#include "database.h"
+#include "memory_catalog.h"
 #include "user_preferences.h"
 #include <iostream>
 #include <memory>
@@ -6,6 +8,7 @@
 #include <string>
 #include <sstream>
 #include <iomanip> // For std::setprecision
+#include <algorithm>
 
 // Function to split a string by delimiter, with additional safety
 std::vector<std::string> split(const std::string& str, char delimiter) {
@@ -55,12 +58,23 @@ void parse_args(int argc, char* argv[],
                 std::vector<std::vector<std::string>>& class_spots,
                 UserPreferences& prefs,
                 bool& output_json,
+                bool& exhaustive,
+                bool& count_only,
+                size_t& sample_budget,
+                uint64_t& sample_seed,
+                bool& use_cursor,
+                std::string& cursor,
                 std::string& db_name,
                 std::string& db_user,
                 std::string& db_password,
                 std::string& db_host,
                 int& db_port,
-                std::string& semester) {
+                std::string& semester,
+                std::string& catalog_path,
+                std::string& ratings_path,
+                std::string& rating_cache_path,
+                size_t& rating_cache_size,
+                long& rating_cache_ttl) {
     for (int i = 1; i < argc; i++) {
         if (!argv[i]) continue;
         std::string arg = safe_string(argv[i]);
@@ -132,6 +146,27 @@ void parse_args(int argc, char* argv[],
         else if (arg == "--json") {
             output_json = true;
         }
+        else if (arg == "--exhaustive") {
+            exhaustive = true;
+        }
+        else if (arg == "--sample") {
+            if (i + 1 < argc && argv[i+1]) {
+                try { sample_budget = std::stoull(safe_string(argv[++i])); } catch (...) {}
+            }
+        }
+        else if (arg == "--seed") {
+            if (i + 1 < argc && argv[i+1]) {
+                try { sample_seed = std::stoull(safe_string(argv[++i])); } catch (...) {}
+            }
+        }
+        else if (arg == "--count") {
+            count_only = true;
+        }
+        else if (arg == "--cursor") {
+            // "start" for the first page, or the cursor printed by the previous page
+            use_cursor = true;
+            if (i + 1 < argc && argv[i+1]) cursor = safe_string(argv[++i]);
+        }
         else if (arg == "--db-name") {
             if (i + 1 < argc && argv[i+1]) db_name = safe_string(argv[++i]);
         }
@@ -155,6 +190,29 @@ void parse_args(int argc, char* argv[],
         else if (arg == "--semester") {
             if (i + 1 < argc && argv[i+1]) semester = safe_string(argv[++i]);
         }
+        else if (arg == "--catalog") {
+            // Scraped semester JSON to read sections from instead of the database
+            if (i + 1 < argc && argv[i+1]) catalog_path = safe_string(argv[++i]);
+        }
+        else if (arg == "--ratings") {
+            // Tab-separated professor ratings to go with --catalog (see memory_catalog.h)
+            if (i + 1 < argc && argv[i+1]) ratings_path = safe_string(argv[++i]);
+        }
+        else if (arg == "--rating-cache") {
+            // File that keeps fetched professor ratings between runs
+            if (i + 1 < argc && argv[i+1]) rating_cache_path = safe_string(argv[++i]);
+        }
+        else if (arg == "--rating-cache-size") {
+            if (i + 1 < argc && argv[i+1]) {
+                try { rating_cache_size = std::stoull(safe_string(argv[++i])); } catch (...) {}
+            }
+        }
+        else if (arg == "--rating-cache-ttl") {
+            // Seconds a cached rating is trusted (0 = forever)
+            if (i + 1 < argc && argv[i+1]) {
+                try { rating_cache_ttl = std::stol(safe_string(argv[++i])); } catch (...) {}
+            }
+        }
     }
 }
 
@@ -194,7 +252,8 @@ std::string escape_json_string(const std::string& input) {
 }
 
 void output_schedules_as_json(const std::vector<std::pair<Schedule, double>>& schedules_with_scores, 
-                             const std::shared_ptr<DatabaseConnection>& db) {
+                             Scheduler& scheduler,
+                             const std::string* next_cursor = nullptr) {
     std::cout << "{\"schedules\":[";
     for (size_t i = 0; i < schedules_with_scores.size(); i++) {
         const auto& [schedule, score] = schedules_with_scores[i];
@@ -204,7 +263,7 @@ void output_schedules_as_json(const std::vector<std::pair<Schedule, double>>& sc
         for (const auto& item : schedule) {
             for (const auto& section : item.sections) {
                 if (section.get_section_type() == "Lecture" && !section.get_instructor().empty()) {
-                    auto ratings = db->get_professor_ratings(section.get_instructor(), item.class_code);
+                    auto ratings = scheduler.professor_rating(section.get_instructor(), item.class_code);
                     if (ratings.quality > 0) {
                         total_quality += ratings.quality;
                         total_difficulty += ratings.difficulty;
@@ -270,7 +329,7 @@ void output_schedules_as_json(const std::vector<std::pair<Schedule, double>>& sc
                 try {
                     std::string prof_name = section.get_instructor();
                     if (!prof_name.empty()) {
-                        auto ratings = db->get_professor_ratings(prof_name, class_code);
+                        auto ratings = scheduler.professor_rating(prof_name, class_code);
                         std::cout << "{\"quality\":" << ratings.quality << ","
                                   << "\"difficulty\":" << ratings.difficulty << ","
                                   << "\"would_take_again\":" << ratings.would_take_again << ","
@@ -291,11 +350,21 @@ void output_schedules_as_json(const std::vector<std::pair<Schedule, double>>& sc
         std::cout << "]}";
         if (i < schedules_with_scores.size() - 1) std::cout << ",";
     }
-    std::cout << "]}";
+    std::cout << "]";
+    if (next_cursor) {
+        std::cout << ",\"cursor\":\"" << escape_json_string(*next_cursor) << "\"";
+    }
+    std::cout << "}";
 }
 
 int main(int argc, char* argv[]) {
     bool output_json = false;
+    bool exhaustive = false;
+    bool count_only = false;
+    size_t sample_budget = 0;
+    uint64_t sample_seed = 0;
+    bool use_cursor = false;
+    std::string cursor_arg;
     try {
         std::vector<std::vector<std::string>> class_spots;
         UserPreferences prefs;
@@ -305,6 +374,10 @@ int main(int argc, char* argv[]) {
     std::string db_host = "localhost";
         int db_port = 5432;
         std::string semester = "20253";
+        std::string catalog_path, ratings_path;
+        std::string rating_cache_path;
+        size_t rating_cache_size = 8192;
+        long rating_cache_ttl = 24 * 60 * 60;   // ratings are re-ingested at most daily
         try {
             const char* db_name_env = std::getenv("USC_DB_NAME");
             if (db_name_env && *db_name_env) db_name = db_name_env;
@@ -318,8 +391,10 @@ int main(int argc, char* argv[]) {
             if (db_port_env && *db_port_env) {
                 try { db_port = std::stoi(db_port_env); } catch (...) {}
             }
+            const char* rating_cache_env = std::getenv("USC_RATING_CACHE");
+            if (rating_cache_env && *rating_cache_env) rating_cache_path = rating_cache_env;
         } catch (...) {}
-        parse_args(argc, argv, class_spots, prefs, output_json, db_name, db_user, db_password, db_host, db_port, semester);
+        parse_args(argc, argv, class_spots, prefs, output_json, exhaustive, count_only, sample_budget, sample_seed, use_cursor, cursor_arg, db_name, db_user, db_password, db_host, db_port, semester, catalog_path, ratings_path, rating_cache_path, rating_cache_size, rating_cache_ttl);
         if (class_spots.empty()) {
             class_spots = {
                 {"CSCI 103", "CSCI 104"},
@@ -328,28 +403,62 @@ int main(int argc, char* argv[]) {
                 {"CSCI 170"}
             };
         }
-        std::shared_ptr<DatabaseConnection> db;
-        try {
-            if (db_name.empty()) db_name = "usc_sched";
-            if (db_user.empty() || db_password.empty()) {
-                throw std::runtime_error("USC_DB_USER/USC_DB_PASSWORD must be provided via env or CLI args");
-            }
-            if (db_host.empty()) db_host = "localhost";
-            if (semester.empty()) semester = "20253";
-            db = std::make_shared<DatabaseConnection>(
-                db_name, db_user, db_password, db_host, db_port, semester
-            );
-        } catch (...) { throw; }
+        std::shared_ptr<CatalogSource> db;
+        if (!catalog_path.empty()) {
+            // Offline run: sections (and ratings, if given) from files, no database
+            db = std::make_shared<FileCatalog>(catalog_path, ratings_path);
+        } else {
+            try {
+                if (db_name.empty()) db_name = "usc_sched";
+                if (db_user.empty() || db_password.empty()) {
+                    throw std::runtime_error("USC_DB_USER/USC_DB_PASSWORD must be provided via env or CLI args");
+                }
+                if (db_host.empty()) db_host = "localhost";
+                if (semester.empty()) semester = "20253";
+                db = std::make_shared<DatabaseConnection>(
+                    db_name, db_user, db_password, db_host, db_port, semester
+                );
+            } catch (...) { throw; }
+        }
         Scheduler scheduler(db, output_json);
-        auto schedules_with_scores = scheduler.build_schedule(class_spots, prefs, 10, output_json);
+        scheduler.set_exhaustive_search(exhaustive);
+        scheduler.set_sampling(sample_budget, sample_seed);
+        scheduler.set_rating_cache(rating_cache_size, std::chrono::seconds(std::max(0L, rating_cache_ttl)),
+                                   rating_cache_path);
+        if (count_only) {
+            ScheduleCount count = scheduler.count_schedules(class_spots, prefs);
+            if (output_json) {
+                std::cout << "{\"count\":" << count.schedules
+                          << ",\"timeSignatures\":" << count.time_signatures
+                          << ",\"saturated\":" << (count.saturated ? "true" : "false") << "}";
+            } else {
+                std::cout << "\nValid schedules: " << count.schedules << (count.saturated ? "+" : "")
+                          << " (" << count.time_signatures << " distinct time signatures)\n";
+            }
+            return 0;
+        }
+        std::vector<std::pair<Schedule, double>> schedules_with_scores;
+        std::string next_cursor;
+        if (use_cursor) {
+            ScheduleCursor after;
+            if (!cursor_arg.empty() && cursor_arg != "start") after = ScheduleCursor::parse(cursor_arg);
+            ScheduleCursor next;
+            schedules_with_scores = scheduler.build_schedule_page(class_spots, prefs, 10, after, next, output_json);
+            next_cursor = next.serialize();
+        } else {
+            schedules_with_scores = scheduler.build_schedule(class_spots, prefs, 10, output_json);
+        }
         if (output_json) {
-            output_schedules_as_json(schedules_with_scores, db);
+            output_schedules_as_json(schedules_with_scores, scheduler, use_cursor ? &next_cursor : nullptr);
         } else {
             std::cout << "\nFound " << schedules_with_scores.size() << " optimal schedules:\n";
             for (size_t i = 0; i < schedules_with_scores.size(); i++) {
                 std::cout << "\nSchedule #" << (i + 1) << ":\n";
                 scheduler.print_schedule(schedules_with_scores[i].first, true);
             }
+            if (use_cursor) {
+                std::cout << "\nNext page cursor: " << next_cursor << "\n";
+            }
         }
         return 0;
     }
@@ -0,0 +1,90 @@
+#include "memory_catalog.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// lower(regexp_replace(s, '[^A-Za-z0-9]', '', 'g')), the database's canonical key
+std::string canonical_key(const std::string& s) {
+    std::string key;
+    key.reserve(s.size());
+    for (unsigned char c : s) {
+        if (std::isalnum(c)) key += static_cast<char>(std::tolower(c));
+    }
+    return key;
+}
+
+double number_or_zero(const std::string& field) {
+    return field.empty() ? 0.0 : std::strtod(field.c_str(), nullptr);
+}
+
+} // namespace
+
+MemoryCatalog::MemoryCatalog(CourseCatalog courses) : courses_(std::move(courses)) {}
+
+void MemoryCatalog::set_rating(const std::string& professor_name, const std::string& class_code,
+                               const ProfessorRating& rating) {
+    ratings_[{canonical_key(professor_name), canonical_key(class_code)}] = rating;
+}
+
+std::vector<std::vector<Section>> MemoryCatalog::find_sections_for_class(const std::string& class_code) {
+    return courses_.find_sections_for_class(class_code);
+}
+
+std::set<std::string> MemoryCatalog::get_required_section_types(const std::string& class_code) const {
+    return courses_.get_required_section_types(class_code);
+}
+
+CatalogSource::ProfessorRating MemoryCatalog::get_professor_ratings(
+    const std::string& professor_name, const std::string& class_code) {
+    ProfessorRating r{};
+    std::string name = canonical_key(professor_name);
+    if (name.empty()) return r;
+
+    // Course-specific entry first, then the professor's overall one
+    auto it = ratings_.find({name, canonical_key(class_code)});
+    if (it != ratings_.end()) return it->second;
+    it = ratings_.find({name, ""});
+    if (it != ratings_.end()) {
+        r.quality = it->second.quality;
+        r.difficulty = it->second.difficulty;
+        r.would_take_again = it->second.would_take_again;
+    }
+    return r;
+}
+
+FileCatalog::FileCatalog(const std::string& courses_path, const std::string& ratings_path)
+    : MemoryCatalog(CourseCatalog::load_json(courses_path)), courses_path_(courses_path) {
+    if (ratings_path.empty()) return;
+
+    std::ifstream file(ratings_path);
+    if (!file) throw std::runtime_error("Cannot open ratings file " + ratings_path);
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        ++line_number;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        std::vector<std::string> fields;
+        std::istringstream columns(line);
+        for (std::string field; std::getline(columns, field, '\t');) fields.push_back(field);
+        if (fields.size() < 5) {
+            throw std::runtime_error("Ratings file " + ratings_path + ", line " +
+                                     std::to_string(line_number) + ": expected at least 5 columns");
+        }
+        fields.resize(7);
+
+        ProfessorRating rating;
+        rating.quality = number_or_zero(fields[2]);
+        rating.difficulty = number_or_zero(fields[3]);
+        rating.would_take_again = number_or_zero(fields[4]);
+        rating.course_specific_quality = number_or_zero(fields[5]);
+        rating.course_specific_difficulty = number_or_zero(fields[6]);
+        set_rating(fields[0], fields[1], rating);
+    }
+}
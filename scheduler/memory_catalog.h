@@ -0,0 +1,60 @@
+#pragma once
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include "catalog_source.h"
+#include "course_catalog.h"
+
+// CatalogSource over data held in the process: a CourseCatalog plus a table
+// of professor ratings. Read-only once filled, so one instance is shared by
+// every thread (open_another returns itself).
+class MemoryCatalog : public CatalogSource {
+public:
+    explicit MemoryCatalog(CourseCatalog courses = CourseCatalog());
+
+    // Rating for a professor in one class, or their overall rating when
+    // class_code is empty. Names and codes match like the database's
+    // canonical keys: case, spaces and punctuation are ignored.
+    void set_rating(const std::string& professor_name, const std::string& class_code,
+                    const ProfessorRating& rating);
+
+    const CourseCatalog& courses() const { return courses_; }
+    CourseCatalog& courses() { return courses_; }
+    size_t rating_count() const { return ratings_.size(); }
+
+    std::vector<std::vector<Section>> find_sections_for_class(const std::string& class_code) override;
+    std::set<std::string> get_required_section_types(const std::string& class_code) const override;
+    ProfessorRating get_professor_ratings(const std::string& professor_name,
+                                          const std::string& class_code) override;
+    std::string source_id() const override { return "memory semester " + courses_.semester(); }
+    std::shared_ptr<CatalogSource> open_another() override { return shared_from_this(); }
+
+private:
+    CourseCatalog courses_;
+    std::map<std::pair<std::string, std::string>, ProfessorRating> ratings_;   // canonical keys
+};
+
+// MemoryCatalog loaded from files: a scraped semester file
+// (usc_<semester>_courses.json, see CourseCatalog::load_json) and optionally
+// a ratings file with one tab-separated line per rating:
+//   professor  class_code  quality  difficulty  would_take_again  course_quality  course_difficulty
+// An empty class_code gives the professor's overall numbers; empty numbers
+// read as 0 and lines starting with '#' are skipped. Exported from Postgres:
+//   psql -At -F $'\t' -c "SELECT p.name, pcr.course_code, p.avg_rating, p.avg_difficulty,
+//       p.would_take_again_percent, pcr.avg_quality, pcr.avg_difficulty
+//       FROM professors p JOIN prof_course_ratings pcr ON pcr.professor_id = p.id
+//       UNION ALL SELECT name, '', avg_rating, avg_difficulty, would_take_again_percent, 0, 0
+//       FROM professors" > ratings.tsv
+// Throws std::runtime_error if a file can't be read or parsed.
+class FileCatalog : public MemoryCatalog {
+public:
+    explicit FileCatalog(const std::string& courses_path, const std::string& ratings_path = "");
+
+    std::string source_id() const override {
+        return "file " + courses_path_ + " semester " + courses().semester();
+    }
+
+private:
+    std::string courses_path_;
+};
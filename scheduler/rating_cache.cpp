@@ -0,0 +1,148 @@
+// rating_cache.cpp
+#include "rating_cache.h"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
+
+namespace {
+
+// First line of every cache file; bump the version when the columns change
+const char* const FILE_HEADER = "# usc-scheduler rating cache v1";
+
+int64_t now_seconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+size_t RatingCache::KeyHash::operator()(const Key& key) const {
+    size_t h = std::hash<std::string>()(key.first);
+    return h ^ (std::hash<std::string>()(key.second) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2));
+}
+
+RatingCache::RatingCache(size_t capacity, std::chrono::seconds ttl)
+    : capacity_(capacity), ttl_(ttl) {}
+
+bool RatingCache::is_expired(const Entry& entry, int64_t now) const {
+    return ttl_.count() > 0 && now - entry.fetched_at >= ttl_.count();
+}
+
+const RatingCache::Rating* RatingCache::find(const Key& key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    if (is_expired(*it->second, now_seconds())) {
+        entries_.erase(it->second);
+        index_.erase(it);
+        ++stats_.expired;
+        ++stats_.misses;
+        return nullptr;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    ++stats_.hits;
+    return &it->second->rating;
+}
+
+bool RatingCache::contains(const Key& key) const {
+    auto it = index_.find(key);
+    return it != index_.end() && !is_expired(*it->second, now_seconds());
+}
+
+void RatingCache::put(const Key& key, const Rating& rating) {
+    insert(key, rating, now_seconds());
+}
+
+void RatingCache::insert(const Key& key, const Rating& rating, int64_t fetched_at) {
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        it->second->rating = rating;
+        it->second->fetched_at = fetched_at;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+    entries_.push_front(Entry{key, rating, fetched_at});
+    index_.emplace(key, entries_.begin());
+    if (capacity_ > 0 && index_.size() > capacity_) {
+        index_.erase(entries_.back().key);
+        entries_.pop_back();
+        ++stats_.evictions;
+    }
+}
+
+void RatingCache::clear() {
+    entries_.clear();
+    index_.clear();
+}
+
+size_t RatingCache::load(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line) || line != FILE_HEADER) return 0;
+
+    // One line per entry, least recently used first:
+    //   fetched_at  instructor  class_code  quality  difficulty  would_take_again  course_quality  course_difficulty
+    const int64_t now = now_seconds();
+    size_t added = 0;
+    while (std::getline(file, line)) {
+        std::vector<std::string> fields;
+        std::istringstream columns(line);
+        for (std::string field; std::getline(columns, field, '\t');) fields.push_back(field);
+        if (fields.size() != 8) continue;
+
+        Entry entry;
+        entry.fetched_at = std::strtoll(fields[0].c_str(), nullptr, 10);
+        entry.key = {fields[1], fields[2]};
+        entry.rating.quality                    = std::strtod(fields[3].c_str(), nullptr);
+        entry.rating.difficulty                 = std::strtod(fields[4].c_str(), nullptr);
+        entry.rating.would_take_again           = std::strtod(fields[5].c_str(), nullptr);
+        entry.rating.course_specific_quality    = std::strtod(fields[6].c_str(), nullptr);
+        entry.rating.course_specific_difficulty = std::strtod(fields[7].c_str(), nullptr);
+        if (is_expired(entry, now)) continue;
+
+        insert(entry.key, entry.rating, entry.fetched_at);
+        ++added;
+    }
+    return added;
+}
+
+bool RatingCache::save(const std::string& path) const {
+    const std::string temp = path + ".tmp" + std::to_string(::getpid());
+    {
+        std::ofstream file(temp, std::ios::trunc);
+        if (!file) return false;
+        // Enough digits that every score computed from a loaded rating is
+        // bit-identical to one computed from the database's
+        file << std::setprecision(std::numeric_limits<double>::max_digits10);
+        file << FILE_HEADER << '\n';
+
+        const int64_t now = now_seconds();
+        for (auto it = entries_.rbegin(); it != entries_.rend(); ++it) {
+            const Entry& e = *it;
+            if (is_expired(e, now)) continue;
+            if (e.key.first.find_first_of("\t\n") != std::string::npos ||
+                e.key.second.find_first_of("\t\n") != std::string::npos) continue;
+            file << e.fetched_at << '\t' << e.key.first << '\t' << e.key.second << '\t'
+                 << e.rating.quality << '\t' << e.rating.difficulty << '\t'
+                 << e.rating.would_take_again << '\t' << e.rating.course_specific_quality << '\t'
+                 << e.rating.course_specific_difficulty << '\n';
+        }
+        if (!file.flush()) {
+            std::remove(temp.c_str());
+            return false;
+        }
+    }
+    if (std::rename(temp.c_str(), path.c_str()) != 0) {
+        std::remove(temp.c_str());
+        return false;
+    }
+    return true;
+}
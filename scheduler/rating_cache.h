@@ -0,0 +1,74 @@
+// rating_cache.h
+#pragma once
+#include "catalog_source.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// Professor ratings by (instructor, class code), as sections carry them,
+// kept across requests. Holds at most `capacity` entries, dropping the
+// least recently used one first, and forgets an entry `ttl` after it was
+// fetched so rating updates from ingestion show up eventually. Can be
+// saved to and loaded from a small text file, so separate CLI runs share
+// it. Not thread-safe: one owner (e.g. a Scheduler) uses it at a time.
+class RatingCache {
+public:
+    using Key = std::pair<std::string, std::string>;
+    using Rating = CatalogSource::ProfessorRating;
+
+    struct Stats {
+        size_t hits = 0;        // find() answered from the cache
+        size_t misses = 0;      // find() came back empty, expired entries included
+        size_t evictions = 0;   // entries dropped to stay within capacity
+        size_t expired = 0;     // entries dropped for being older than the ttl
+        double hit_rate() const { return hits + misses ? double(hits) / (hits + misses) : 0.0; }
+    };
+
+    // capacity 0 = unbounded, ttl 0 = entries never expire
+    explicit RatingCache(size_t capacity = 0, std::chrono::seconds ttl = std::chrono::seconds(0));
+
+    // The cached rating, now the most recently used, or null (counted as a
+    // hit or a miss). The pointer is valid until the next put().
+    const Rating* find(const Key& key);
+    // Whether find() would hit, without counting or reordering anything
+    bool contains(const Key& key) const;
+    // Add or replace a rating fetched just now
+    void put(const Key& key, const Rating& rating);
+
+    size_t size() const { return index_.size(); }
+    size_t capacity() const { return capacity_; }
+    std::chrono::seconds ttl() const { return ttl_; }
+    const Stats& stats() const { return stats_; }
+    void clear();
+
+    // Entries of a file written by save() that are still within the ttl,
+    // keeping their fetch times and recency order. A missing, unreadable or
+    // foreign file loads nothing. Returns the number of entries added.
+    size_t load(const std::string& path);
+    // Write every live entry to `path` (through a temporary file renamed
+    // into place, so concurrent runs never see half a file); false on I/O error.
+    bool save(const std::string& path) const;
+
+private:
+    struct Entry {
+        Key key;
+        Rating rating;
+        int64_t fetched_at;   // seconds since the epoch
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+
+    size_t capacity_;
+    std::chrono::seconds ttl_;
+    std::list<Entry> entries_;   // most recently used first
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+    Stats stats_;
+
+    bool is_expired(const Entry& entry, int64_t now) const;
+    void insert(const Key& key, const Rating& rating, int64_t fetched_at);
+};
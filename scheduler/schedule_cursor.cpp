@@ -0,0 +1,94 @@
+// schedule_cursor.cpp
+#include "schedule_cursor.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+#include <stdexcept>
+
+size_t ScheduleCursor::first_unreturned(double s, const PackedSchedule& p, size_t count) const {
+    if (!started) return 0;
+    if (s != score) return s > score ? count : 0;
+    if (p != ids) return p < ids ? count : 0;
+    return std::min(expansion, count);
+}
+
+// v1:<fingerprint>:<page>:<score as hex float>:<id,id,...>:<expansion>, or
+// v1:<fingerprint>:<page>:end once the ranking is exhausted
+std::string ScheduleCursor::serialize() const {
+    std::ostringstream out;
+    char buf[64];
+    std::snprintf(buf, sizeof buf, "%016llx", static_cast<unsigned long long>(fingerprint));
+    out << "v1:" << buf << ':' << page << ':';
+    if (exhausted) {
+        out << "end";
+        return out.str();
+    }
+    if (!started) {
+        out << "start";
+        return out.str();
+    }
+    std::snprintf(buf, sizeof buf, "%a", score);
+    out << buf << ':';
+    for (size_t i = 0; i < ids.size(); ++i) out << (i ? "," : "") << ids[i];
+    out << ':' << expansion;
+    return out.str();
+}
+
+ScheduleCursor ScheduleCursor::parse(const std::string& text) {
+    std::vector<std::string> fields;
+    std::istringstream in(text);
+    std::string field;
+    while (std::getline(in, field, ':')) fields.push_back(field);
+    if (fields.size() < 4 || fields[0] != "v1") throw std::invalid_argument("malformed schedule cursor");
+
+    ScheduleCursor cursor;
+    try {
+        cursor.fingerprint = std::stoull(fields[1], nullptr, 16);
+        cursor.page = static_cast<unsigned>(std::stoul(fields[2]));
+        if (fields[3] == "end") {
+            cursor.started = cursor.exhausted = true;
+            return cursor;
+        }
+        if (fields[3] == "start") return cursor;
+        if (fields.size() != 6) throw std::invalid_argument("malformed schedule cursor");
+
+        cursor.started = true;
+        cursor.score = std::strtod(fields[3].c_str(), nullptr);
+        std::istringstream id_stream(fields[4]);
+        std::string id;
+        while (std::getline(id_stream, id, ',')) cursor.ids.push_back(static_cast<PackageId>(std::stoul(id)));
+        cursor.expansion = std::stoull(fields[5]);
+    } catch (const std::invalid_argument&) {
+        throw std::invalid_argument("malformed schedule cursor");
+    } catch (const std::out_of_range&) {
+        throw std::invalid_argument("malformed schedule cursor");
+    }
+    return cursor;
+}
+
+uint64_t ScheduleCursor::fingerprint_of(const std::vector<std::vector<std::string>>& class_spots,
+                                        const UserPreferences& prefs,
+                                        const std::string& source,
+                                        uint64_t salt) {
+    std::string key;
+    for (const auto& spot : class_spots) {
+        for (const auto& code : spot) key += code + ',';
+        key += '|';
+    }
+    for (const auto& day : prefs.get_days_off()) key += day + ',';
+    key += '|' + std::to_string(prefs.get_time_of_day_preference()) +
+           '|' + std::to_string(prefs.get_lecture_length_preference()) +
+           '|' + std::to_string(prefs.get_avoid_labs()) +
+           '|' + std::to_string(prefs.get_avoid_discussions()) +
+           '|' + std::to_string(prefs.get_exclude_full_sections());
+    key += '|' + source;
+    if (salt != 0) key += '|' + std::to_string(salt);
+
+    uint64_t hash = 1469598103934665603ull;          // FNV-1a
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
@@ -0,0 +1,43 @@
+// schedule_cursor.h
+#pragma once
+#include "schedule_generator.h"
+#include "user_preferences.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Position in the ranking of a request's schedules, so "next page" returns
+// the schedules right after the last one already returned, with no overlap
+// or gap between pages. It resumes the ranking, not the search: the cursor
+// holds no search state, so page N enumerates and scores the schedules of
+// pages 1..N-1 again and drops them (see Scheduler::build_schedule_page).
+//
+// Schedules are ranked by score (highest first), then by their packed
+// package ids, then by their index among the equally scored schedules a
+// packed one expands to. A cursor holds that key for the last schedule of a
+// page - its score is the ceiling every later page stays under - plus a
+// fingerprint of the request it belongs to.
+struct ScheduleCursor {
+    uint64_t fingerprint = 0;
+    unsigned page = 0;            // pages returned so far
+    bool started = false;         // false: nothing returned yet (first page)
+    bool exhausted = false;       // the last page came back short
+    double score = 0;
+    PackedSchedule ids;
+    size_t expansion = 0;         // next expansion of `ids` still to return
+
+    // Where `ids` (scored `score`, standing for `count` schedules) resumes:
+    // 0 if it comes entirely after the cursor, `count` if it was fully returned
+    size_t first_unreturned(double score, const PackedSchedule& ids, size_t count) const;
+
+    std::string serialize() const;
+    static ScheduleCursor parse(const std::string& text);   // throws std::invalid_argument
+
+    // Identifies the request (spots and preferences, against the catalog
+    // named by `source`, see CatalogSource::source_id) a cursor was issued
+    // for; `salt` covers anything else that changes the ranked set (0 = nothing)
+    static uint64_t fingerprint_of(const std::vector<std::vector<std::string>>& class_spots,
+                                   const UserPreferences& prefs,
+                                   const std::string& source,
+                                   uint64_t salt = 0);
+};
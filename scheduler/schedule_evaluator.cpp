@@ -13,7 +13,7 @@ T clamp(const T& value, const T& low, const T& high) {
 }
 
 /* ───────────────────────── ctor ───────────────────────── */
-ScheduleEvaluator::ScheduleEvaluator(std::shared_ptr<DatabaseConnection> db)
+ScheduleEvaluator::ScheduleEvaluator(std::shared_ptr<CatalogSource> db)
 : db(std::move(db)) {}
 
 /* ───────────────── section‑level helpers ──────────────── */
@@ -29,9 +29,138 @@ ScheduleEvaluator::get_section_time_info(const Section& sec) const {
     return {sh,eh,dur};
 }
 
+bool ScheduleEvaluator::in_time_zone(int pref, double h) {
+    switch(pref){
+        case -1: return h>=8  && h<11.5;
+        case  1: return h>=11.5 && h<16;
+        case  2: return h>=16 && h<=21;
+    }
+    return false;
+}
+
+bool ScheduleEvaluator::is_avoided(const Section& s, const UserPreferences& prefs) {
+    std::string t = s.get_section_type();
+    bool is_lab = t=="Lab";
+    bool is_disc = t=="Discussion" || t=="Quiz";
+    return (is_lab && prefs.get_avoid_labs()) ||
+           (is_disc&& prefs.get_avoid_discussions());
+}
+
+/* strips the Postgres array quoting; false if there is no instructor to rate */
+bool ScheduleEvaluator::usable_instructor(std::string& prof) {
+    if (prof.empty() || prof=="{}" || prof=="TBA") return false;
+    prof.erase(std::remove_if(prof.begin(),prof.end(),
+                              [](char c){return c=='{'||c=='}'||c=='\"';}),prof.end());
+    return true;
+}
+
+CatalogSource::ProfessorRating
+ScheduleEvaluator::pull_rating(const std::string& prof,const std::string& code,
+                               RatingCache* cache) const {
+    std::pair<std::string,std::string> key{prof,code};
+    if (cache) {
+        if (const auto* hit = cache->find(key)) return *hit;
+    }
+    auto r = db->get_professor_ratings(prof,code);
+    if (cache) cache->put(key,r);
+    return r;
+}
+
+/* ratings with neither an overall nor a course score are left out of the bundle */
+bool ScheduleEvaluator::usable_rating(const CatalogSource::ProfessorRating& r) {
+    return r.quality>0 || r.course_specific_quality>0;
+}
+
+ScheduleEvaluator::PackageRatings
+ScheduleEvaluator::package_ratings(const PackageTable& table, RatingCache& cache,
+                                   const RatingMap& prefetched) {
+    /* 1. every (instructor, class) pair once; kept here as well, since a
+          bounded cache may evict some before the layout below reads them */
+    RatingMap known;
+    std::vector<std::pair<std::string,std::string>> missing;
+    for (const auto& options : table.spots)
+        for (const auto& item : options)
+            for (const auto& s : item.sections) {
+                std::string prof = s.get_instructor();
+                if (!usable_instructor(prof)) continue;
+                std::pair<std::string,std::string> key{prof,item.class_code};
+                if (known.count(key)) continue;
+                if (const auto* hit = cache.find(key)) {
+                    known.emplace(key,*hit);
+                } else if (auto p = prefetched.find(key); p!=prefetched.end()) {
+                    known.emplace(key,p->second);
+                    cache.put(key,p->second);
+                } else {
+                    known.emplace(key,CatalogSource::ProfessorRating{});
+                    missing.push_back(key);
+                }
+            }
+
+    for (const auto& [key,r] : fetch_ratings(missing)) {
+        known[key] = r;
+        cache.put(key,r);
+    }
+
+    /* 2. lay them out per package, in the order professor_bundle reads them */
+    PackageRatings out(table.spots.size());
+    for (size_t spot=0; spot<table.spots.size(); ++spot) {
+        out[spot].resize(table.spots[spot].size());
+        for (size_t id=0; id<table.spots[spot].size(); ++id) {
+            const ScheduleItem& item = table.spots[spot][id];
+            for (const auto& s : item.sections) {
+                std::string prof = s.get_instructor();
+                if (!usable_instructor(prof)) continue;
+                const auto& r = known.at({prof,item.class_code});
+                if (usable_rating(r)) out[spot][id].push_back(r);
+            }
+        }
+    }
+    return out;
+}
+
+std::vector<std::pair<std::string,std::string>> ScheduleEvaluator::missing_ratings(
+    const std::map<std::string, std::vector<std::vector<Section>>>& catalog,
+    const RatingCache& cache) {
+    std::vector<std::pair<std::string,std::string>> missing;
+    std::set<std::pair<std::string,std::string>> seen;
+    for (const auto& [code,groups] : catalog)
+        for (const auto& group : groups)
+            for (const auto& s : group) {
+                std::string prof = s.get_instructor();
+                if (!usable_instructor(prof)) continue;
+                std::pair<std::string,std::string> key{prof,code};
+                if (!cache.contains(key) && seen.insert(key).second) missing.push_back(key);
+            }
+    return missing;
+}
+
+ScheduleEvaluator::RatingMap
+ScheduleEvaluator::fetch_ratings(const std::vector<std::pair<std::string,std::string>>& pairs) {
+    RatingMap out;
+    if (pairs.empty()) return out;
+    std::vector<CatalogSource::ProfessorRating> found;
+    if (db->get_professor_ratings_bulk(pairs,found)) {
+        for (size_t i=0;i<pairs.size();++i) out[pairs[i]] = found[i];
+    } else {
+        for (const auto& key : pairs) out[key] = pull_rating(key.first,key.second,nullptr);
+    }
+    return out;
+}
+
 /* ───────────────── schedule‑wide helpers ──────────────── */
 std::set<std::string>
 ScheduleEvaluator::get_schedule_days_used(const Schedule& sched) const {
+    return days_used(sched);
+}
+
+std::pair<double,double>
+ScheduleEvaluator::get_schedule_time_range(const Schedule& sched) const {
+    return time_range(sched);
+}
+
+template <typename Items>
+std::set<std::string>
+ScheduleEvaluator::days_used(const Items& sched) const {
     uint8_t bits = 0;
     for (const auto& item : sched)
         for (const auto& s : item.sections) bits |= s.get_day_bits();
@@ -44,8 +173,9 @@ ScheduleEvaluator::get_schedule_days_used(const Schedule& sched) const {
     return out;
 }
 
+template <typename Items>
 std::pair<double,double>
-ScheduleEvaluator::get_schedule_time_range(const Schedule& sched) const {
+ScheduleEvaluator::time_range(const Items& sched) const {
     double earliest = 24.0, latest = 0.0;
     bool any = false;
     for (const auto& it : sched)
@@ -60,65 +190,66 @@ ScheduleEvaluator::get_schedule_time_range(const Schedule& sched) const {
 }
 
 /* ─────────────────────── bundles ──────────────────────── */
-double ScheduleEvaluator::professor_bundle(
-        const Schedule& sched,
-        std::map<std::pair<std::string,std::string>,
-                 DatabaseConnection::ProfessorRating>* cache) const {
-
-    auto pull_rating = [&](const std::string& prof,const std::string& code){
-        std::pair<std::string,std::string> key{prof,code};
-        if (cache) {
-            auto it = cache->find(key);
-            if (it!=cache->end()) return it->second;
-        }
-        auto r = db->get_professor_ratings(prof,code);
-        if (cache) (*cache)[key] = r;
-        return r;
-    };
+namespace {
 
+/* professor-bundle sums; one definition so every caller adds in the same order */
+struct RatingTotals {
     double sum_overall=0, sum_course=0, sum_wta=0, sum_diff=0;
     int cnt = 0;
 
-    for (const auto& it : sched)
-        for (const auto& s : it.sections) {
-            std::string prof = s.get_instructor();
-            if (prof.empty() || prof=="{}" || prof=="TBA") continue;
-            prof.erase(std::remove_if(prof.begin(),prof.end(),
-                                      [](char c){return c=='{'||c=='}'||c=='\"';}),prof.end());
-
-            auto r = pull_rating(prof,it.class_code);
-            if (r.quality<=0 && r.course_specific_quality<=0) continue;
-
-            sum_overall += r.quality;
-            sum_course  += (r.course_specific_quality>0 ? r.course_specific_quality
-                                                        : r.quality);   // fallback
-            sum_wta     += r.would_take_again/20.0;       // 0‑5
-            sum_diff    += r.difficulty;
-            ++cnt;
-        }
+    void add(const CatalogSource::ProfessorRating& r) {
+        sum_overall += r.quality;
+        sum_course  += (r.course_specific_quality>0 ? r.course_specific_quality
+                                                    : r.quality);   // fallback
+        sum_wta     += r.would_take_again/20.0;       // 0‑5
+        sum_diff    += r.difficulty;
+        ++cnt;
+    }
+
+    double bundle() const {
+        if (cnt==0) return 0;
 
-    if (cnt==0) return 0;
+        double avg_overall = sum_overall/cnt;
+        double avg_course  = sum_course /cnt;
+        double avg_wta     = sum_wta    /cnt;
+        double avg_diff    = sum_diff   /cnt;
 
-    double avg_overall = sum_overall/cnt;
-    double avg_course  = sum_course /cnt;
-    double avg_wta     = sum_wta    /cnt;
-    double avg_diff    = sum_diff   /cnt;
+        /* difficulty is better when low – invert */
+        double inv_diff = 5.0 - clamp(avg_diff,0.0,5.0);
 
-    /* difficulty is better when low – invert */
-    double inv_diff = 5.0 - clamp(avg_diff,0.0,5.0);
+        /* bundle weight = 40 → multiply by 2 to stretch 0‑20 → 0‑40 */
+        double raw20 = avg_overall + avg_course + avg_wta + inv_diff; // 0‑20
+        return raw20 * 2.0;                                           // 0‑40
+    }
+};
+
+} // namespace
+
+template <typename Items>
+double ScheduleEvaluator::professor_bundle(
+        const Items& sched,
+        RatingCache* cache) const {
+
+    RatingTotals totals;
+    for (const auto& it : sched)
+        for (const auto& s : it.sections) {
+            std::string prof = s.get_instructor();
+            if (!usable_instructor(prof)) continue;
 
-    /* bundle weight = 40 → multiply by 2 to stretch 0‑20 → 0‑40 */
-    double raw20 = avg_overall + avg_course + avg_wta + inv_diff; // 0‑20
-    return raw20 * 2.0;                                           // 0‑40
+            auto r = pull_rating(prof,it.class_code,cache);
+            if (usable_rating(r)) totals.add(r);
+        }
+    return totals.bundle();
 }
 
-double ScheduleEvaluator::day_bundle(const Schedule& sched,
+template <typename Items>
+double ScheduleEvaluator::day_bundle(const Items& sched,
                                      const UserPreferences& prefs) const {
     if (prefs.get_days_off().empty()) return 0;      // no preference
 
-    std::set<std::string> used = get_schedule_days_used(sched);
-    std::set<std::string> unwanted(prefs.get_days_off().begin(),
-                                   prefs.get_days_off().end());
+    std::set<std::string> used = days_used(sched);
+    std::vector<std::string> days_off = prefs.get_days_off();   // returned by value
+    std::set<std::string> unwanted(days_off.begin(), days_off.end());
 
     /* max 20 pts, lose 5 for every “bad” day that contains class */
     double score = 20.0;
@@ -127,35 +258,28 @@ double ScheduleEvaluator::day_bundle(const Schedule& sched,
     return std::max(0.0,score);
 }
 
-double ScheduleEvaluator::time_bundle(const Schedule& sched,
+template <typename Items>
+double ScheduleEvaluator::time_bundle(const Items& sched,
                                       const UserPreferences& prefs) const {
     int pref = prefs.get_time_of_day_preference();   // -1 morn, 0 none, 1 aft, 2 eve
     if (pref==0) return 0;                           // no preference
 
-    auto [earliest,latest] = get_schedule_time_range(sched);
+    auto [earliest,latest] = time_range(sched);
     if (earliest<0) return 0;
 
-    auto in_zone = [&](double h){
-        switch(pref){
-            case -1: return h>=8  && h<11.5;
-            case  1: return h>=11.5 && h<16;
-            case  2: return h>=16 && h<=21;
-        }
-        return false;
-    };
-
     /* start at 20, subtract 5 for each section whose *start* is outside the zone */
     double score = 20.0;
     for (const auto& it : sched)
         for (const auto& s : it.sections) {
             auto [sh,eh,du] = get_section_time_info(s);
             if (sh<0) continue;
-            if (!in_zone(sh)) score -= 5.0;
+            if (!in_time_zone(pref,sh)) score -= 5.0;
         }
     return std::max(0.0,score);
 }
 
-double ScheduleEvaluator::misc_bundle(const Schedule& sched,
+template <typename Items>
+double ScheduleEvaluator::misc_bundle(const Items& sched,
                                       const UserPreferences& prefs) const {
     /* 10 pts lecture‑length, 10 pts lab/disc */
     double score = 0;
@@ -186,14 +310,8 @@ double ScheduleEvaluator::misc_bundle(const Schedule& sched,
     int bad = 0;
     if (prefs.get_avoid_labs() || prefs.get_avoid_discussions()){
         for (const auto& it : sched)
-            for (const auto& s : it.sections){
-                std::string t = s.get_section_type();
-                bool is_lab = t=="Lab";
-                bool is_disc = t=="Discussion" || t=="Quiz";
-                if ((is_lab && prefs.get_avoid_labs()) ||
-                    (is_disc&& prefs.get_avoid_discussions()))
-                    ++bad;
-            }
+            for (const auto& s : it.sections)
+                if (is_avoided(s,prefs)) ++bad;
         score += std::max(0, 2 - bad) * 5.0; // 0,5,10
     }
 
@@ -203,8 +321,7 @@ double ScheduleEvaluator::misc_bundle(const Schedule& sched,
 /* ───────────────────── evaluation ─────────────────────── */
 double ScheduleEvaluator::evaluate_schedule_with_cache(
     const Schedule& sched,const UserPreferences& prefs,bool verbose,
-    std::map<std::pair<std::string,std::string>,
-             DatabaseConnection::ProfessorRating>& cache) {
+    RatingCache& cache) {
 
     if (sched.empty()) return -999;
 
@@ -225,22 +342,14 @@ double ScheduleEvaluator::evaluate_schedule_with_cache(
     std::cout << "Schedule evaluation - Raw score: " << raw 
               << " | Boosted: " << boosted_raw << std::endl;
 
-    // Maximum-generosity normalization curve - essentially a very flat curve
-    // that keeps all scores between 6.0 and 10.0
-    double normalized = 0;
-    if (boosted_raw >= 60) {  // High scores: 60+ → 8.5-10.0
-        normalized = 8.5 + (boosted_raw - 60) * 1.5 / 40.0;
+    double normalized = normalize_score(raw);
+    if (boosted_raw >= 60) {
         std::cout << "Score bracket: High (60+) → " << normalized << std::endl;
-    } else if (boosted_raw >= 45) {  // Good scores: 45-60 → 7.5-8.5
-        normalized = 7.5 + (boosted_raw - 45) * 1.0 / 15.0;
+    } else if (boosted_raw >= 45) {
         std::cout << "Score bracket: Good (45-60) → " << normalized << std::endl;
-    } else {  // All other scores: 0-45 → 6.0-7.5
-        normalized = 6.0 + (boosted_raw / 45.0) * 1.5;
+    } else {
         std::cout << "Score bracket: Baseline (0-45) → " << normalized << std::endl;
     }
-    
-    // Ensure we stay in the 0-10 range
-    normalized = clamp(normalized, 0.0, 10.0);
 
     // DEBUGGING: Always print score details for low scores
     if (verbose || normalized < 6.0){
@@ -257,17 +366,97 @@ double ScheduleEvaluator::evaluate_schedule_with_cache(
     return normalized; // Return normalized score instead of raw
 }
 
+double ScheduleEvaluator::evaluate_packed(const PackageTable& table,
+                                          const PackedSchedule& sched,
+                                          const UserPreferences& prefs,
+                                          RatingCache& cache) {
+    if (sched.empty()) return -999;
+
+    PackedScheduleView items(table, sched);
+    /* same summation order as the parts map above (alphabetical) */
+    double raw = day_bundle(items,prefs)
+               + misc_bundle(items,prefs)
+               + professor_bundle(items,&cache)
+               + time_bundle(items,prefs);
+    return normalize_score(raw);
+}
+
+double ScheduleEvaluator::evaluate_packed(const PackageTable& table,
+                                          const PackedSchedule& sched,
+                                          const UserPreferences& prefs,
+                                          const PackageRatings& ratings) const {
+    if (sched.empty()) return -999;
+
+    RatingTotals totals;
+    for (size_t spot=0; spot<sched.size(); ++spot)
+        for (const auto& r : ratings[spot][sched[spot]]) totals.add(r);
+
+    PackedScheduleView items(table, sched);
+    double raw = day_bundle(items,prefs)
+               + misc_bundle(items,prefs)
+               + totals.bundle()
+               + time_bundle(items,prefs);
+    return normalize_score(raw);
+}
+
+PackageScore ScheduleEvaluator::summarize_package(const ScheduleItem& item,
+                                                  const UserPreferences& prefs,
+                                                  const std::vector<CatalogSource::ProfessorRating>& ratings) const {
+    PackageScore out;
+    for (const auto& s : item.sections) {
+        out.day_bits |= s.get_day_bits() & 0x1F;
+        if (is_avoided(s,prefs)) ++out.avoided;
+
+        auto [sh,eh,du] = get_section_time_info(s);
+        if (sh>=0) {
+            ++out.timed;
+            if (!in_time_zone(prefs.get_time_of_day_preference(),sh)) ++out.out_of_zone;
+        }
+        if (s.get_section_type()=="Lecture" && du>0) {
+            out.lecture_hours += du;
+            ++out.lectures;
+        }
+    }
+    /* in section order, so the sums match professor_bundle's */
+    for (const auto& r : ratings) {
+        out.rating_sum += r.quality
+                        + (r.course_specific_quality>0 ? r.course_specific_quality : r.quality)
+                        + r.would_take_again/20.0;
+        out.difficulty_sum += r.difficulty;
+        ++out.rated;
+    }
+    return out;
+}
+
+double ScheduleEvaluator::normalize_score(double raw) {
+    // Apply a massive base boost to all raw scores to prevent very low scores
+    // The +40 baseline ensures even zero-scored schedules get a respectable score
+    double boosted_raw = raw + 40.0;
+
+    // Maximum-generosity normalization curve - essentially a very flat curve
+    // that keeps all scores between 6.0 and 10.0
+    double normalized = 0;
+    if (boosted_raw >= 60) {  // High scores: 60+ → 8.5-10.0
+        normalized = 8.5 + (boosted_raw - 60) * 1.5 / 40.0;
+    } else if (boosted_raw >= 45) {  // Good scores: 45-60 → 7.5-8.5
+        normalized = 7.5 + (boosted_raw - 45) * 1.0 / 15.0;
+    } else {  // All other scores: 0-45 → 6.0-7.5
+        normalized = 6.0 + (boosted_raw / 45.0) * 1.5;
+    }
+
+    // Ensure we stay in the 0-10 range
+    return clamp(normalized, 0.0, 10.0);
+}
+
 /* thin wrappers */
 double ScheduleEvaluator::evaluate_schedule(const Schedule& s,
                                             const UserPreferences& p,bool v){
-    static thread_local std::map<std::pair<std::string,std::string>,
-                                 DatabaseConnection::ProfessorRating> dummy;
+    static thread_local RatingCache dummy;
     return evaluate_schedule_with_cache(s,p,v,dummy);
 }
 double ScheduleEvaluator::evaluate_schedule_with_cache(const Schedule& s,
               const UserPreferences& p,bool v){
-    static thread_local std::map<std::pair<std::string,std::string>,
-                                 DatabaseConnection::ProfessorRating> local;
+    static thread_local RatingCache local;
     return evaluate_schedule_with_cache(s,p,v,local);
 }
 
@@ -1,5 +1,6 @@
 #pragma once
-#include "database.h"
+#include "catalog_source.h"
+#include "rating_cache.h"
 #include "user_preferences.h"
 #include "section.h"
 #include "schedule_generator.h"
@@ -9,9 +10,31 @@
 #include <memory>
 #include <set>
 
+// One package's contribution to each bundle, kept as sums and counts so the
+// bundles of any set of packages can be rebuilt (or bounded) without
+// touching their sections again
+struct PackageScore {
+    double rating_sum = 0;      // overall + course + would-take-again (0-5 each)
+    double difficulty_sum = 0;
+    int rated = 0;              // sections with a usable rating
+    uint8_t day_bits = 0;       // Mon..Fri
+    int timed = 0;              // sections with a start and end time
+    int out_of_zone = 0;        // timed sections starting outside the preferred window
+    double lecture_hours = 0;
+    int lectures = 0;
+    int avoided = 0;            // labs/discussions the user asked to avoid
+};
+
 class ScheduleEvaluator {
 public:
-    explicit ScheduleEvaluator(std::shared_ptr<DatabaseConnection> db);
+    using RatingCache = ::RatingCache;
+    using RatingMap = std::map<std::pair<std::string,std::string>,
+                               CatalogSource::ProfessorRating>;
+    // [spot][id]: the ratings that count for that package, one per rated
+    // section in section order, so scoring needs no name lookups at all
+    using PackageRatings = std::vector<std::vector<std::vector<CatalogSource::ProfessorRating>>>;
+
+    explicit ScheduleEvaluator(std::shared_ptr<CatalogSource> db);
 
     /* plain (no cache) */
     double evaluate_schedule(const Schedule& sched,
@@ -23,14 +46,52 @@ public:
         const Schedule& sched,
         const UserPreferences& prefs,
         bool verbose,
-        std::map<std::pair<std::string,std::string>,
-                 DatabaseConnection::ProfessorRating>& cache);
+        RatingCache& cache);
 
     /* convenience – creates its own cache */
     double evaluate_schedule_with_cache(const Schedule& sched,
                                         const UserPreferences& prefs = {},
                                         bool verbose = false);
 
+    /* packed schedule straight from the search – same score, no copies, no logging */
+    double evaluate_packed(const PackageTable& table,
+                           const PackedSchedule& sched,
+                           const UserPreferences& prefs,
+                           RatingCache& cache);
+
+    /* every rating the table's packages need: looked up in `cache`, then in
+       `prefetched`, the rest fetched with fetch_ratings(); whatever did not
+       come from `cache` is added to it. Each pair is one find() on `cache`,
+       so its stats show how much of the request it answered. */
+    PackageRatings package_ratings(const PackageTable& table, RatingCache& cache,
+                                   const RatingMap& prefetched = {});
+
+    /* (instructor, class) pairs of fetched sections that `cache` lacks, each
+       once and without touching its stats – lets ratings load while
+       packages are still being built */
+    static std::vector<std::pair<std::string,std::string>> missing_ratings(
+        const std::map<std::string, std::vector<std::vector<Section>>>& catalog,
+        const RatingCache& cache);
+
+    /* `pairs` in one bulk query (one by one if that fails) */
+    RatingMap fetch_ratings(const std::vector<std::pair<std::string,std::string>>& pairs);
+
+    /* same score again, ratings taken from package_ratings() – read-only,
+       so any number of threads can share one evaluator */
+    double evaluate_packed(const PackageTable& table,
+                           const PackedSchedule& sched,
+                           const UserPreferences& prefs,
+                           const PackageRatings& ratings) const;
+
+    /* per-package bundle inputs, for bounding partial schedules; `ratings`
+       is the package's entry of package_ratings() */
+    PackageScore summarize_package(const ScheduleItem& item,
+                                   const UserPreferences& prefs,
+                                   const std::vector<CatalogSource::ProfessorRating>& ratings) const;
+
+    /* raw (0‑100) bundle total → 0‑10 display score */
+    static double normalize_score(double raw);
+
     std::map<std::string,double> get_score_breakdown(
         const Schedule& sched,
         const UserPreferences& prefs = {}) const;
@@ -47,14 +108,27 @@ public:
                                const Schedule& sched) const;
 
 private:
-    std::shared_ptr<DatabaseConnection> db;
+    std::shared_ptr<CatalogSource> db;
 
-    /* internal helpers */
+    /* internal helpers – Items is a Schedule or a PackedScheduleView */
     std::tuple<double,double,double> get_section_time_info(const Section& s) const;
-    double professor_bundle(const Schedule& s,
-                            std::map<std::pair<std::string,std::string>,
-                                     DatabaseConnection::ProfessorRating>* cache) const;
-    double day_bundle(const Schedule& s,const UserPreferences& p) const;
-    double time_bundle(const Schedule& s,const UserPreferences& p) const;
-    double misc_bundle(const Schedule& s,const UserPreferences& p) const;
+    static bool in_time_zone(int pref, double hour);
+    static bool is_avoided(const Section& s, const UserPreferences& p);
+    CatalogSource::ProfessorRating pull_rating(const std::string& prof,
+                                                    const std::string& code,
+                                                    RatingCache* cache) const;
+    static bool usable_instructor(std::string& prof);
+    static bool usable_rating(const CatalogSource::ProfessorRating& r);
+    template <typename Items>
+    std::set<std::string> days_used(const Items& s) const;
+    template <typename Items>
+    std::pair<double,double> time_range(const Items& s) const;
+    template <typename Items>
+    double professor_bundle(const Items& s, RatingCache* cache) const;
+    template <typename Items>
+    double day_bundle(const Items& s,const UserPreferences& p) const;
+    template <typename Items>
+    double time_bundle(const Items& s,const UserPreferences& p) const;
+    template <typename Items>
+    double misc_bundle(const Items& s,const UserPreferences& p) const;
 };
@@ -1,64 +1,39 @@
 #include "schedule_generator.h"
-#include "time_utils.h"
 #include <iostream>
 #include <algorithm>
 #include <thread>
+#include <mutex>
 #include <chrono>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <random>
 
 // Forward declaration
-bool is_valid_schedule(const Schedule& schedule, const std::vector<std::vector<std::string>>& class_spots, DatabaseConnection* db);
+bool is_complete_package(const ScheduleItem& item,
+                         const std::vector<std::string>& spot_classes,
+                         const std::set<std::string>& required_types);
 
-ScheduleGenerator::ScheduleGenerator(std::shared_ptr<DatabaseConnection> db)
-    : db(db),
-      schedule_pool(std::make_unique<std::pmr::synchronized_pool_resource>()),
-      item_allocator(schedule_pool.get()) {
+ScheduleGenerator::ScheduleGenerator(std::shared_ptr<CatalogSource> db)
+    : db(db) {
 }
 
 bool ScheduleGenerator::packages_conflict(
-    const std::vector<Section>& pkg1, 
-    const std::vector<Section>& pkg2) const {
-    // Quick check - if either package is empty, they can't conflict
-    if (pkg1.empty() || pkg2.empty()) {
-        return false;
+    const ScheduleItem& pkg1, 
+    const ScheduleItem& pkg2) const {
+    // Fast path: AND the precompiled week bitmaps
+    if (!pkg1.occupancy.intersects(pkg2.occupancy)) {
+        return false;  // No shared 5-minute slot, cannot conflict
     }
-    
-    // Fast path for day conflicts using standard bit operations (no SIMD needed)
-    // First gather all day bits from both packages
-    uint8_t days_pkg1 = 0, days_pkg2 = 0;
-    
-    for (const auto& section : pkg1) days_pkg1 |= section.get_day_bits();
-    for (const auto& section : pkg2) days_pkg2 |= section.get_day_bits();
-    
-    // If there's no overlap in days at all, we can quickly return false
-    if ((days_pkg1 & days_pkg2) == 0) {
-        return false;  // No shared days, cannot conflict
+    if (pkg1.occupancy.exact && pkg2.occupancy.exact) {
+        return true;   // Slot-aligned meetings: a shared slot is a real overlap
     }
     
-    // Day-by-day optimized check with regular bit operations
-    for (const auto& sec1 : pkg1) {
-        uint8_t sec1_days = sec1.get_day_bits();
-        if (sec1_days == 0) continue; // Skip sections with no days
-        
-        for (const auto& sec2 : pkg2) {
-            uint8_t sec2_days = sec2.get_day_bits();
-            if (sec2_days == 0) continue; // Skip sections with no days
-            
-            // Check day overlap with fast bit operation
-            uint8_t day_overlap = sec1_days & sec2_days;
-            if (day_overlap == 0) continue; // No overlap on days
-            
-            // Check if either section has no time info
-            if (sec1.get_start_time().empty() || sec1.get_end_time().empty() ||
-                sec2.get_start_time().empty() || sec2.get_end_time().empty() ||
-                sec1.get_start_time() == "TBA" || sec2.get_start_time() == "TBA") {
-                continue;
-            }
-            
-            // Only now check for time overlap - most expensive operation
-            if (TimeUtils::times_overlap(
-                sec1.get_start_time(), sec1.get_end_time(),
-                sec2.get_start_time(), sec2.get_end_time())) {
+    // Some meeting is not on a 5-minute boundary, so the shared slot may
+    // just be rounding - confirm on the compiled minutes
+    for (const auto& sec1 : pkg1.sections) {
+        for (const auto& sec2 : pkg2.sections) {
+            if (meetings_overlap(sec1, sec2)) {
                 return true; // Conflict found!
             }
         }
@@ -70,7 +45,9 @@ bool ScheduleGenerator::packages_conflict(
 
 std::vector<SpotOptions> ScheduleGenerator::prepare_spot_options(
         const std::vector<std::vector<std::string>>& class_spots,
-        const UserPreferences& prefs) {
+        std::map<std::string, std::set<std::string>>& required_types,
+        const UserPreferences& prefs,
+        const SectionsFetched& fetched) {
 
     std::vector<SpotOptions> result;
 
@@ -83,19 +60,41 @@ std::vector<SpotOptions> ScheduleGenerator::prepare_spot_options(
         std::cout << '\n';
     }
 
+    auto trim = [](std::string code) {
+        code.erase(0,  code.find_first_not_of(" \t\r\n"));
+        code.erase(   code.find_last_not_of(" \t\r\n") + 1);
+        return code;
+    };
+
+    /* one round-trip for every distinct class of the request */
+    std::vector<std::string> codes;
+    for (const auto& spot : class_spots)
+        for (const auto& raw_code : spot) codes.push_back(trim(raw_code));
+    std::sort(codes.begin(), codes.end());
+    codes.erase(std::unique(codes.begin(), codes.end()), codes.end());
+    std::cout << "Looking up sections for " << codes.size() << " classes in one query\n";
+    const auto catalog = db->find_sections_for_classes(codes);
+    if (fetched) fetched(catalog);
+
     /* ─────────────────────────────────────────────────────────────────────── */
     for (size_t spot_idx = 0; spot_idx < class_spots.size(); ++spot_idx) {
         SpotOptions spot_options;
 
         for (const auto& raw_code : class_spots[spot_idx]) {
 
-            std::string code = raw_code;
-            code.erase(0,  code.find_first_not_of(" \t\r\n"));
-            code.erase(   code.find_last_not_of(" \t\r\n") + 1);
+            std::string code = trim(raw_code);
+
+            auto found = catalog.find(code);
+            if (found == catalog.end()) { std::cerr << "  ✖ no sections for " << code << "\n"; continue; }
+            auto groups = found->second;
 
-            std::cout << "Looking up sections for class: '" << code << "'\n";
-            auto groups = db->find_sections_for_class(code);
-            if (groups.empty()) { std::cerr << "  ✖ no sections\n"; continue; }
+            /* every section type the class offers must be in a package; the
+               groups already hold them all, so no separate type query */
+            std::set<std::string>& required = required_types[code];
+            for (const auto& g : groups)
+                for (const Section& s : g)
+                    if (!s.get_section_type().empty()) required.insert(s.get_section_type());
+            if (required.empty()) required.insert("Lecture");
 
             /* filter full sections if user asked for it */
             if (prefs.get_exclude_full_sections()) {
@@ -106,8 +105,16 @@ std::vector<SpotOptions> ScheduleGenerator::prepare_spot_options(
                        }), g.end());
                 }
             }
-            if (std::all_of(groups.begin(), groups.end(),
-                            [](auto& g){ return g.empty(); })) continue;
+            groups.erase(std::remove_if(groups.begin(), groups.end(),
+                                        [](const auto& g){ return g.empty(); }), groups.end());
+            std::set<std::string> offered;
+            for (const auto& g : groups) offered.insert(g[0].get_section_type());
+            auto missing = std::find_if(required.begin(), required.end(),
+                [&](const std::string& type){ return !offered.count(type); });
+            if (missing != required.end()) {        // no package could be complete
+                std::cout << "  ✖ no open " << *missing << " section for " << code << '\n';
+                continue;
+            }
 
             /* ── choose anchor group (prefer anything containing \"Lecture\") */
             int anchor_g = -1;
@@ -155,10 +162,9 @@ std::vector<SpotOptions> ScheduleGenerator::prepare_spot_options(
                 if (lists.empty()) {
                     /* class needs only one type → one package per anchor */
                     std::vector<Section> pkg{anchor};
-                    spot_options.emplace_back(
-                        spot_idx, code,
-                        static_cast<int>(spot_options.size()),
-                        std::move(pkg));
+                    ScheduleItem item(spot_idx, code, static_cast<int>(spot_options.size()), std::move(pkg));
+                    if (is_complete_package(item, class_spots[spot_idx], required))
+                        spot_options.push_back(std::move(item));
                 } else {
                     std::vector<size_t> idx(lists.size(), 0);
                     bool done = false;
@@ -168,10 +174,9 @@ std::vector<SpotOptions> ScheduleGenerator::prepare_spot_options(
                         for (size_t k = 0; k < lists.size(); ++k)
                             pkg.push_back(lists[k][idx[k]]);
 
-                        spot_options.emplace_back(
-                            spot_idx, code,
-                            static_cast<int>(spot_options.size()),
-                            std::move(pkg));
+                        ScheduleItem item(spot_idx, code, static_cast<int>(spot_options.size()), std::move(pkg));
+                        if (is_complete_package(item, class_spots[spot_idx], required))
+                            spot_options.push_back(std::move(item));
 
                         /* odometer */
                         for (size_t k = 0; ; ++k) {
@@ -184,7 +189,7 @@ std::vector<SpotOptions> ScheduleGenerator::prepare_spot_options(
             } // end anchor loop
         }     // end class loop
 
-        if (!spot_options.empty()) result.push_back(std::move(spot_options));
+        result.push_back(std::move(spot_options));   // may be empty; the caller decides
     }         // end spot loop
     /* ─────────────────────────────────────────────────────────────────────── */
 
@@ -193,271 +198,827 @@ std::vector<SpotOptions> ScheduleGenerator::prepare_spot_options(
 
 
 
-void ScheduleGenerator::extend_schedules(
-    const std::vector<Schedule>& current_schedules,
-    const SpotOptions& next_options,
-    std::vector<Schedule>& result,
-    int spot_idx,
-    int limit) {
+bool ScheduleGenerator::packages_compatible(const ScheduleItem& pkg1,
+                                            const ScheduleItem& pkg2) const {
+    // Check for class code duplicates
+    if (pkg1.class_code == pkg2.class_code) return false;
 
-    size_t n_emitted = 0;
-    auto batch_start = std::chrono::high_resolution_clock::now();
-    
-    // Pre-reserve approximate space in result vector
-    size_t estimated_size = std::min(
-        static_cast<size_t>(limit),
-        current_schedules.size() * next_options.size() / 4
-    );
-    result.reserve(result.size() + estimated_size);
-    
-    // Precompute all conflicts - this is our optimization
-    auto compatibility_matrix = precompute_compatibility_matrix(current_schedules, next_options, spot_idx);
-    
-    // Now use the precomputed matrix for schedule building
-    for (size_t i = 0; i < current_schedules.size(); i++) {
-        // Skip if we've already reached the limit
-        if (result.size() >= static_cast<size_t>(limit)) {
+    // Check for time conflicts
+    return !packages_conflict(pkg1, pkg2);
+}
+
+std::vector<SpotOptions> ScheduleGenerator::collapse_equivalent_packages(SpotOptions& spot) const {
+    // Everything the compatibility test and the evaluator read from a package
+    auto signature = [](const ScheduleItem& item) {
+        std::string key = item.class_code;
+        for (const auto& s : item.sections) {
+            key += '\x1f' + s.get_section_type() + '\x1e' + std::to_string(s.get_day_bits()) +
+                   '\x1e' + s.get_start_time() + '\x1e' + s.get_end_time() +
+                   '\x1e' + s.get_instructor();
+        }
+        return key;
+    };
+
+    SpotOptions representatives;
+    std::vector<SpotOptions> others;
+    std::unordered_map<std::string, size_t> class_of;
+    for (auto& item : spot) {
+        auto [it, inserted] = class_of.emplace(signature(item), representatives.size());
+        if (inserted) {
+            representatives.push_back(std::move(item));
+            others.emplace_back();
+        } else {
+            others[it->second].push_back(std::move(item));
+        }
+    }
+    spot = std::move(representatives);
+    return others;
+}
+
+CompatibilityIndex ScheduleGenerator::build_compatibility_index(
+    const std::vector<SpotOptions>& spots,
+    const std::vector<int>& reused_from,
+    const PackageTable* previous) const {
+    std::vector<size_t> sizes;
+    for (const auto& spot : spots) sizes.push_back(spot.size());
+
+    // One interleaved mask block per spot: a package is tested against a
+    // whole spot per kernel call. A shared slot is a certain clash only when
+    // both masks are slot-aligned, and the same class never fits twice, so
+    // those few packages are listed per spot and re-checked one by one.
+    std::vector<WeekMaskBlock> blocks;
+    std::vector<std::vector<size_t>> inexact(spots.size());
+    std::vector<std::unordered_map<std::string, std::vector<size_t>>> by_class(spots.size());
+    for (size_t spot = 0; spot < spots.size(); ++spot) {
+        std::vector<const WeekMask*> masks;
+        for (size_t q = 0; q < spots[spot].size(); ++q) {
+            const ScheduleItem& pkg = spots[spot][q];
+            masks.push_back(&pkg.occupancy);
+            if (!pkg.occupancy.exact) inexact[spot].push_back(q);
+            by_class[spot][pkg.class_code].push_back(q);
+        }
+        blocks.emplace_back(masks);
+    }
+
+    auto fill = [&](size_t a, size_t p, size_t b, CompatibilityIndex::Word* row) {
+        const ScheduleItem& pkg = spots[a][p];
+        blocks[b].disjoint_from(pkg.occupancy, row);
+        auto set_bit = [&](size_t q, bool on) {
+            const auto bit = CompatibilityIndex::Word(1) << (q % CompatibilityIndex::WORD_BITS);
+            if (on) row[q / CompatibilityIndex::WORD_BITS] |= bit;
+            else row[q / CompatibilityIndex::WORD_BITS] &= ~bit;
+        };
+        auto recheck = [&](size_t q) { set_bit(q, packages_compatible(pkg, spots[b][q])); };
+        if (!pkg.occupancy.exact) {
+            for (size_t q = 0; q < spots[b].size(); ++q) recheck(q);
             return;
         }
-        
-        const auto& schedule = current_schedules[i];
-        
-        for (size_t j = 0; j < next_options.size(); j++) {
-            const auto& option = next_options[j];
-            
-            // Skip if option is for a different spot
-            if (option.spot_idx != spot_idx) {
-                continue;
-            }
-            
-            // Use precomputed compatibility instead of checking again
-            if (compatibility_matrix[i][j]) {
-                // No conflict - create new schedule
-                Schedule new_schedule = copy_schedule_pooled(schedule);
-                new_schedule.push_back(option);
-                result.push_back(std::move(new_schedule));
-            }
+        for (size_t q : inexact[b]) recheck(q);
+        auto same = by_class[b].find(pkg.class_code);
+        if (same != by_class[b].end())
+            for (size_t q : same->second) set_bit(q, false);
+    };
+
+    CompatibilityIndex index(sizes);
+    for (size_t a = 0; a < spots.size(); ++a)
+        for (size_t b = a + 1; b < spots.size(); ++b) {
+            // Both spots unchanged since the previous request: same packages, same bits
+            if (previous && reused_from[a] >= 0 && reused_from[b] >= 0)
+                index.copy_pair(a, b, previous->compat, reused_from[a], reused_from[b]);
+            else
+                index.compute_pair(a, b, fill);
+        }
+    return index;
+}
+
+PropagationStats ScheduleGenerator::enforce_arc_consistency(PackageTable& table) const {
+    using Word = CompatibilityIndex::Word;
+    const CompatibilityIndex& compat = table.compat;
+    const size_t num_spots = table.spots.size();
+    PropagationStats result;
+
+    table.live.assign(num_spots, {});
+    for (size_t spot = 0; spot < num_spots; ++spot) {
+        table.live[spot].resize(compat.words(spot));
+        compat.fill_all(spot, table.live[spot].data());
+    }
+
+    // Arcs (a, b): every live package of a needs a live partner in b. When a
+    // loses packages, the arcs into a are revised again.
+    std::vector<std::pair<size_t, size_t>> queue;
+    std::vector<char> queued(num_spots * num_spots, 0);
+    auto enqueue = [&](size_t a, size_t b) {
+        if (queued[a * num_spots + b]) return;
+        queued[a * num_spots + b] = 1;
+        queue.emplace_back(a, b);
+    };
+    for (size_t a = 0; a < num_spots; ++a)
+        for (size_t b = 0; b < num_spots; ++b)
+            if (a != b) enqueue(a, b);
+
+    while (!queue.empty()) {
+        auto [a, b] = queue.back();
+        queue.pop_back();
+        queued[a * num_spots + b] = 0;
+        ++result.revisions;
+
+        bool changed = false;
+        Word* live_a = table.live[a].data();
+        const Word* live_b = table.live[b].data();
+        CompatibilityIndex::for_each_bit(live_a, compat.words(a), [&](size_t p) {
+            const Word* row = compat.row(a, p, b);
+            for (size_t w = 0; w < compat.words(b); ++w)
+                if (row[w] & live_b[w]) return;
+            live_a[p / CompatibilityIndex::WORD_BITS] &= ~(Word(1) << (p % CompatibilityIndex::WORD_BITS));
+            ++result.packages_removed;
+            changed = true;
+        });
+        if (!changed) continue;
+        for (size_t c = 0; c < num_spots; ++c)
+            if (c != a && c != b) enqueue(c, a);
+    }
+
+    for (size_t spot = 0; spot < num_spots; ++spot) {
+        std::set<std::string> listed, kept;
+        for (size_t p = 0; p < table.spots[spot].size(); ++p) {
+            listed.insert(table.spots[spot][p].class_code);
+            if (table.live[spot][p / CompatibilityIndex::WORD_BITS] >> (p % CompatibilityIndex::WORD_BITS) & 1)
+                kept.insert(table.spots[spot][p].class_code);
         }
+        result.classes_removed += listed.size() - kept.size();
     }
+    return result;
 }
 
-std::vector<std::vector<bool>> ScheduleGenerator::precompute_compatibility_matrix(
-    const std::vector<Schedule>& schedules,
-    const SpotOptions& options,
-    int spot_idx) {
-    
-    // Create matrix: [schedule_idx][option_idx] = true if compatible, false if conflict
-    std::vector<std::vector<bool>> compatibility_matrix(schedules.size());
-    
-    // For each schedule, check compatibility with all options
-    for (size_t i = 0; i < schedules.size(); i++) {
-        compatibility_matrix[i].resize(options.size(), false);
-        
-        for (size_t j = 0; j < options.size(); j++) {
-            // Skip options for different spots
-            if (options[j].spot_idx != spot_idx) {
+void ScheduleGenerator::load_domains(const PackageTable& table,
+                                     const SearchControl& control,
+                                     SearchScratch& scratch) const {
+    // Options for an open spot = its usable packages AND the compatibility
+    // rows of every package already chosen; no pair is re-tested here
+    const CompatibilityIndex& compat = table.compat;
+    auto& domains = scratch.domains[scratch.depth];
+    for (size_t spot = 0; spot < table.spots.size(); ++spot) {
+        if (scratch.chosen[spot] != NO_PACKAGE) continue;
+        CompatibilityIndex::Word* domain = domains.data() + control.word_offset[spot];
+        const size_t num_words = compat.words(spot);
+        std::copy_n(control.initial.data() + control.word_offset[spot], num_words, domain);
+        for (size_t other = 0; other < table.spots.size(); ++other) {
+            if (scratch.chosen[other] == NO_PACKAGE) continue;
+            const CompatibilityIndex::Word* row = compat.row(other, scratch.chosen[other], spot);
+            for (size_t w = 0; w < num_words; ++w) domain[w] &= row[w];
+        }
+    }
+}
+
+size_t ScheduleGenerator::pick_spot(const PackageTable& table,
+                                    const SearchControl& control,
+                                    const SearchScratch& scratch) const {
+    if (control.ordering == SpotOrdering::AsListed) {
+        for (size_t spot = 0; spot < table.spots.size(); ++spot)
+            if (scratch.chosen[spot] == NO_PACKAGE) return spot;
+    }
+    if (control.ordering == SpotOrdering::MostConstrained) {
+        for (size_t spot : control.static_order)
+            if (scratch.chosen[spot] == NO_PACKAGE) return spot;
+    }
+
+    // Dynamic: fewest options left given what is already chosen, ties going
+    // to the statically most constrained spot
+    const auto& domains = scratch.domains[scratch.depth];
+    size_t best_spot = table.spots.size(), best_count = SIZE_MAX;
+    for (size_t spot : control.static_order) {
+        if (scratch.chosen[spot] != NO_PACKAGE) continue;
+        const CompatibilityIndex::Word* domain = domains.data() + control.word_offset[spot];
+        size_t count = 0;
+        for (size_t w = 0; w < table.compat.words(spot); ++w) count += __builtin_popcountll(domain[w]);
+        if (count < best_count) {
+            best_spot = spot;
+            best_count = count;
+            if (count == 0) break;
+        }
+    }
+    return best_spot;
+}
+
+bool ScheduleGenerator::search_subtree(const PackageTable& table,
+                                       const ScheduleVisitor& visit,
+                                       SearchScratch& scratch,
+                                       SearchControl& control) {
+    const size_t depth = scratch.depth;
+    const size_t num_spots = table.spots.size();
+    ++scratch.nodes_per_depth[depth];
+
+    if (control.keep && !(*control.keep)(scratch.chosen, scratch.worker)) {
+        control.pruned.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Complete schedule - hand it to the visitor
+    if (depth == num_spots) {
+        // Reserve a slot first so concurrent workers never overshoot the limit
+        if (control.emitted.fetch_add(1) >= control.limit ||
+            !visit(scratch.chosen, scratch.worker)) {
+            control.stopped = true;
+            return false;
+        }
+        return true;
+    }
+
+    const CompatibilityIndex& compat = table.compat;
+    const size_t spot = pick_spot(table, control, scratch);
+    const auto& domains = scratch.domains[depth];
+    auto& next_domains = scratch.domains[depth + 1];
+    const CompatibilityIndex::Word* options = domains.data() + control.word_offset[spot];
+
+    for (size_t w = 0; w < compat.words(spot); ++w) {
+        for (CompatibilityIndex::Word word = options[w]; word; word &= word - 1) {
+            if (control.stopped.load(std::memory_order_relaxed)) return false;
+            PackageId option = static_cast<PackageId>(
+                w * CompatibilityIndex::WORD_BITS + __builtin_ctzll(word));
+            scratch.chosen[spot] = option;
+
+            // Someone ran out of work: give this subtree away rather than
+            // descending into it. Leaves are never worth a task.
+            if (control.pool && depth + 1 < num_spots && control.pool->has_idle_workers()) {
+                PackedSchedule prefix = scratch.chosen;
+                scratch.chosen[spot] = NO_PACKAGE;
+                control.splits.fetch_add(1, std::memory_order_relaxed);
+                control.pool->spawn(scratch.worker,
+                    [this, &table, &visit, &control, prefix = std::move(prefix)](unsigned worker) {
+                        search_task(table, visit, control, prefix, worker);
+                    });
                 continue;
             }
-            
-            // Check if this option conflicts with this schedule
-            bool has_conflict = false;
-            const auto& schedule = schedules[i];
-            const auto& option = options[j];
-            
-            // Check for class code duplicates
-            for (const auto& existing_item : schedule) {
-                if (existing_item.class_code == option.class_code) {
-                    has_conflict = true;
-                    break;
-                }
-                
-                // Check for time conflicts
-                if (packages_conflict(existing_item.sections, option.sections)) {
-                    has_conflict = true;
-                    break;
+
+            // Narrow every other open spot by this package's compatibility
+            // rows; if one is left with nothing, the choice is a dead end
+            bool wiped_out = false;
+            for (size_t other = 0; other < num_spots && !wiped_out; ++other) {
+                if (scratch.chosen[other] != NO_PACKAGE) continue;
+                const size_t offset = control.word_offset[other];
+                const CompatibilityIndex::Word* row = compat.row(spot, option, other);
+                CompatibilityIndex::Word any = 0;
+                for (size_t k = 0; k < compat.words(other); ++k) {
+                    next_domains[offset + k] = domains[offset + k] & row[k];
+                    any |= next_domains[offset + k];
                 }
+                wiped_out = any == 0;
+            }
+            if (wiped_out) {
+                ++scratch.wipeouts;
+                scratch.chosen[spot] = NO_PACKAGE;
+                continue;
             }
-            
-            // Store result: true if compatible (no conflict), false otherwise
-            compatibility_matrix[i][j] = !has_conflict;
+
+            scratch.depth = depth + 1;
+            bool keep_going = search_subtree(table, visit, scratch, control);
+            scratch.depth = depth;
+            scratch.chosen[spot] = NO_PACKAGE;
+            if (!keep_going) return false;
         }
     }
-    
-    return compatibility_matrix;
+    return true;
 }
 
-std::vector<Schedule> ScheduleGenerator::generate_all_valid_schedules(
+std::shared_ptr<const PackageTable> ScheduleGenerator::prepare_packages(
     const std::vector<std::vector<std::string>>& class_spots,
     const UserPreferences& prefs,
-    int limit) {
-    
-    // Add timing code at the start
-    auto build_start_time = std::chrono::high_resolution_clock::now();
-    
-    // Prepare options first
-    std::vector<SpotOptions> all_spot_options = prepare_spot_options(class_spots, prefs);
+    const SectionsFetched& sections_fetched) {
 
-    if (all_spot_options.empty() || all_spot_options[0].empty()) {
-        std::cerr << "✖ No valid packages found for the first spot — aborting.\n";
-        return {};
-    }
-    
-    // Generate initial schedules (spot 0)
-    std::vector<Schedule> current_schedules;
-    current_schedules.reserve(std::min(static_cast<size_t>(limit), all_spot_options[0].size()));
-    
-    for (const auto& option : all_spot_options[0]) {
-        // Use memory pool for initial schedules
-        Schedule schedule = create_pooled_schedule(all_spot_options.size());
-        schedule.push_back(option);
-        current_schedules.push_back(std::move(schedule));
-        
-        // Early stopping if too many options
-        if (current_schedules.size() >= static_cast<size_t>(limit)) {
-            std::cout << "Warning: Too many options for first spot, limiting to " 
-                      << limit << std::endl;
+    auto table = std::make_shared<PackageTable>();
+    table->class_spots = class_spots;
+    const size_t num_spots = class_spots.size();
+    table->spots.resize(num_spots);
+    table->alternatives.resize(num_spots);
+
+    // Spots that were also in the previous request (same source, classes
+    // and full-section filter) and are still fresh are taken from its
+    // table; only the rest are fetched
+    const auto now = std::chrono::steady_clock::now();
+    const std::string source = db->source_id();
+    std::vector<std::string> keys;
+    std::vector<std::chrono::steady_clock::time_point> fetched_at(num_spots, now);
+    std::vector<int> reused_from(num_spots, -1);
+    std::vector<std::vector<std::string>> missing;
+    std::vector<size_t> missing_at;
+    std::vector<char> taken(previous_keys.size(), 0);
+    for (size_t spot = 0; spot < num_spots; ++spot) {
+        std::string key = source + '|' + std::to_string(prefs.get_exclude_full_sections());
+        for (const auto& code : class_spots[spot]) key += '|' + code;
+        keys.push_back(key);
+
+        for (size_t j = 0; j < previous_keys.size(); ++j) {
+            if (taken[j] || previous_keys[j] != key) continue;
+            if (now - previous_fetched[j] >= spot_ttl) continue;   // seats may have changed
+            taken[j] = 1;
+            reused_from[spot] = static_cast<int>(j);
             break;
         }
+        if (reused_from[spot] < 0) {
+            missing.push_back(class_spots[spot]);
+            missing_at.push_back(spot);
+        }
     }
 
-    
-    
-    // For later spots, we can parallelize
-    for (size_t spot_idx = 1; spot_idx < all_spot_options.size(); ++spot_idx) {
-        std::vector<Schedule> next_schedules;
-        
-        // Determine number of threads based on workload and available cores
-        unsigned int thread_count = std::min(
-            std::thread::hardware_concurrency(),
-            static_cast<unsigned int>(current_schedules.size() / 1000 + 1)
-        );
-        
-        if (thread_count > 1 && current_schedules.size() > 5000) {
-            // Parallel processing for large workloads
-            std::vector<std::vector<Schedule>> thread_results(thread_count);
-            std::vector<std::thread> threads;
-            
-            size_t chunk_size = current_schedules.size() / thread_count;
-            
-            for (unsigned int t = 0; t < thread_count; ++t) {
-                size_t start = t * chunk_size;
-                size_t end = (t == thread_count - 1) ? current_schedules.size() : (t + 1) * chunk_size;
-                
-                threads.emplace_back([this, &all_spot_options, &current_schedules, 
-                                    &thread_results, t, start, end, spot_idx, limit, thread_count]() {
-                    std::vector<Schedule> local_results;
-                    extend_schedules(
-                        std::vector<Schedule>(current_schedules.begin() + start, current_schedules.begin() + end),
-                        all_spot_options[spot_idx],
-                        local_results,
-                        spot_idx,
-                        limit / thread_count
-                    );
-                    thread_results[t] = std::move(local_results);
-                });
-            }
+    size_t before = 0, after = 0;
+    if (!missing.empty()) {
+        std::vector<SpotOptions> fetched = prepare_spot_options(missing, table->required_types, prefs,
+                                                                  sections_fetched);
+        for (size_t k = 0; k < missing_at.size(); ++k) {
+            before += fetched[k].size();
+            table->alternatives[missing_at[k]] = collapse_equivalent_packages(fetched[k]);
+            after += fetched[k].size();
+            table->spots[missing_at[k]] = std::move(fetched[k]);
+            // Fetched as spot k of `missing`: number them as their real spot
+            const int spot = static_cast<int>(missing_at[k]);
+            for (auto& item : table->spots[spot]) item.spot_idx = spot;
+            for (auto& others : table->alternatives[spot])
+                for (auto& item : others) item.spot_idx = spot;
+        }
+    }
+    size_t reused = 0;
+    for (size_t spot = 0; spot < num_spots; ++spot) {
+        if (reused_from[spot] < 0) continue;
+        const size_t j = reused_from[spot];
+        fetched_at[spot] = previous_fetched[j];
+        table->spots[spot] = previous->spots[j];
+        table->alternatives[spot] = previous->alternatives[j];
+        for (auto& item : table->spots[spot]) item.spot_idx = static_cast<int>(spot);
+        for (auto& others : table->alternatives[spot])
+            for (auto& item : others) item.spot_idx = static_cast<int>(spot);
+        for (const auto& item : table->spots[spot])
+            table->required_types[item.class_code] = previous->required_types.at(item.class_code);
+        ++reused;
+    }
+    if (reused > 0) {
+        std::cout << "Reused " << reused << " of " << num_spots
+                  << " spot(s) from the previous request" << std::endl;
+    }
+    if (!missing.empty()) {
+        std::cout << "Time signatures: " << before << " packages collapse to " << after
+                  << " equivalence classes" << std::endl;
+    }
 
+    size_t empty_spots = std::count_if(table->spots.begin(), table->spots.end(),
+                                       [](const SpotOptions& spot) { return spot.empty(); });
+    if (num_spots == 0 || table->spots[0].empty()) {
+        std::cerr << "✖ No valid packages found for the first spot — aborting.\n";
+        return nullptr;
+    }
+    if (empty_spots > 0) {
+        std::cerr << "✖ " << empty_spots
+                  << " spot(s) have no valid packages — no complete schedule possible.\n";
+        return nullptr;
+    }
 
-            
-            // Wait for all threads
-            for (auto& thread : threads) {
-                thread.join();
-            }
-            
-            // Combine results
-            for (auto& result : thread_results) {
-                next_schedules.insert(next_schedules.end(), 
-                                   std::make_move_iterator(result.begin()), 
-                                   std::make_move_iterator(result.end()));
-                
-                if (next_schedules.size() >= static_cast<size_t>(limit)) {
-                    next_schedules.resize(limit);
-                    break;
-                }
-            }
-        } else {
-            // Sequential processing for small workloads
-            extend_schedules(current_schedules, all_spot_options[spot_idx], next_schedules, spot_idx, limit);
-        }
-        
-        // Use swap for efficiency
-        current_schedules.swap(next_schedules);
-
-        // ── DEBUG: how many schedules after spot_idx
-        auto spot_end = std::chrono::high_resolution_clock::now();
-        auto spot_ms  = std::chrono::duration_cast<std::chrono::milliseconds>(
-                             spot_end - build_start_time
-                          ).count();
-        std::cout << "[Generator] after spot " << spot_idx
-                   << ": " << current_schedules.size()
-                   << " schedules built (total build time so far: "                    << spot_ms << "ms)"
-                   << std::endl;
-
-        
-        // Check limit
-        if (current_schedules.size() >= static_cast<size_t>(limit)) {
-            current_schedules.resize(limit);
+    auto index_start = std::chrono::high_resolution_clock::now();
+    table->compat = build_compatibility_index(table->spots, reused_from, previous.get());
+    auto index_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - index_start).count();
+    std::cout << "Compatibility index: " << table->compat.pairs_tested() << " package pairs, "
+              << table->compat.memory_bytes() / 1024 << " KiB, built in " << index_ms << "ms" << std::endl;
+
+    auto propagate_start = std::chrono::high_resolution_clock::now();
+    propagation = enforce_arc_consistency(*table);
+    auto propagate_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - propagate_start).count();
+    size_t representatives = 0;
+    for (const auto& spot : table->spots) representatives += spot.size();
+    std::cout << "Arc consistency: removed " << propagation.packages_removed << " of "
+              << representatives << " packages (" << propagation.classes_removed
+              << " classes) in " << propagation.revisions << " revisions, "
+              << propagate_ms << "ms" << std::endl;
+    for (size_t spot = 0; spot < num_spots; ++spot) {
+        bool any = false;
+        for (auto word : table->live[spot]) any = any || word != 0;
+        if (!any) {
+            std::cerr << "✖ Spot " << spot
+                      << " has no package that fits every other spot — no complete schedule possible.\n";
+            break;
         }
     }
+
+    previous = table;
+    previous_keys = std::move(keys);
+    previous_fetched = std::move(fetched_at);
+    return table;
+}
+
+size_t ScheduleGenerator::for_each_valid_schedule(
+    const PackageTable& table,
+    const ScheduleVisitor& visit,
+    unsigned num_workers,
+    size_t limit,
+    const SubtreeFilter& keep) {
     
-    // At the end of the function, right before returning:
+    // Add timing code at the start
+    auto build_start_time = std::chrono::high_resolution_clock::now();
+    if (table.spots.empty()) return 0;
+
+    // The search starts as a single task at the empty schedule; workers
+    // split the tree off on demand, so skewed subtrees still keep everyone busy
+    if (num_workers == 0) num_workers = std::max(1u, std::thread::hardware_concurrency());
+    if (!pool || pool->size() != num_workers) pool = std::make_unique<WorkStealingPool>(num_workers);
+
+    const size_t num_spots = table.spots.size();
+    SearchControl control;
+    control.limit = limit;
+    if (keep) control.keep = &keep;
+    if (num_workers > 1) control.pool = pool.get();
+    control.ordering = ordering;
+    init_control(table, control, num_workers);
+
+    std::vector<WorkStealingPool::Task> roots;
+    PackedSchedule empty(num_spots, NO_PACKAGE);
+    roots.push_back([this, &table, &visit, &control, empty](unsigned worker) {
+        search_task(table, visit, control, empty, worker);
+    });
+    pool->run(std::move(roots));
+
+    stats = SearchStats();
+    stats.nodes_per_depth.assign(num_spots + 1, 0);
+    for (const auto& scratch : control.scratch)
+        for (size_t d = 0; d <= num_spots; ++d) stats.nodes_per_depth[d] += scratch.nodes_per_depth[d];
+    stats.schedules = std::min(control.emitted.load(), limit);
+    stats.pruned = control.pruned.load();
+    stats.splits = control.splits.load();
+    for (const auto& scratch : control.scratch) stats.wipeouts += scratch.wipeouts;
+
+    size_t delivered = std::min(control.emitted.load(), limit);
     auto build_end_time = std::chrono::high_resolution_clock::now();
     auto build_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
         build_end_time - build_start_time).count();
     std::cout << "Total schedule building time: " << build_elapsed << "ms for " 
-              << current_schedules.size() << " schedules" << std::endl;
-    
-    // Filter schedules to only those that fill all spots and have all required section types
-    std::vector<Schedule> valid_schedules;
-    for (const auto& sched : current_schedules) {
-        if (is_valid_schedule(sched, class_spots, db.get())) {
-            valid_schedules.push_back(sched);
-            if (valid_schedules.size() >= static_cast<size_t>(limit)) break;
+              << delivered << " schedules (" << num_workers << " search threads)" << std::endl;
+    if (num_workers > 1) {
+        std::cout << "Work stealing: " << control.splits.load() << " subtrees handed to idle workers" << std::endl;
+    }
+    std::cout << "Forward checking: " << stats.wipeouts << " choices cut before descending" << std::endl;
+    if (keep) {
+        std::cout << "Branch-and-bound pruned " << control.pruned.load() << " subtrees" << std::endl;
+    }
+    if (control.emitted.load() > limit) {
+        std::cout << "Warning: schedule limit of " << limit << " reached, search stopped early" << std::endl;
+    }
+    return delivered;
+}
+
+void ScheduleGenerator::init_control(const PackageTable& table, SearchControl& control,
+                                     unsigned num_workers) const {
+    // Live packages of every spot, and the most-constrained-first order
+    const size_t num_spots = table.spots.size();
+    size_t total_words = 0;
+    for (size_t spot = 0; spot < num_spots; ++spot) {
+        control.word_offset.push_back(total_words);
+        total_words += table.compat.words(spot);
+    }
+    control.initial.assign(total_words, 0);
+    std::vector<size_t> usable(num_spots, 0);
+    for (size_t spot = 0; spot < num_spots; ++spot) {
+        CompatibilityIndex::Word* initial = control.initial.data() + control.word_offset[spot];
+        if (table.live.empty()) table.compat.fill_all(spot, initial);
+        else std::copy(table.live[spot].begin(), table.live[spot].end(), initial);
+        for (size_t w = 0; w < table.compat.words(spot); ++w) usable[spot] += __builtin_popcountll(initial[w]);
+        control.static_order.push_back(spot);
+    }
+    std::stable_sort(control.static_order.begin(), control.static_order.end(),
+                     [&](size_t a, size_t b) { return usable[a] < usable[b]; });
+
+    control.scratch.resize(num_workers);
+    for (unsigned worker = 0; worker < num_workers; ++worker) {
+        SearchScratch& scratch = control.scratch[worker];
+        scratch.worker = worker;
+        scratch.chosen.assign(num_spots, NO_PACKAGE);
+        scratch.domains.assign(num_spots + 1, std::vector<CompatibilityIndex::Word>(total_words));
+        scratch.nodes_per_depth.assign(num_spots + 1, 0);
+    }
+}
+
+void ScheduleGenerator::search_task(const PackageTable& table,
+                                    const ScheduleVisitor& visit,
+                                    SearchControl& control,
+                                    const PackedSchedule& prefix,
+                                    unsigned worker) {
+    if (control.stopped.load(std::memory_order_relaxed)) return;
+    SearchScratch& scratch = control.scratch[worker];
+    scratch.chosen.assign(prefix.begin(), prefix.end());
+    scratch.depth = std::count_if(prefix.begin(), prefix.end(),
+                                  [](PackageId id) { return id != NO_PACKAGE; });
+    load_domains(table, control, scratch);
+    search_subtree(table, visit, scratch, control);
+}
+
+namespace {
+
+uint64_t add_saturating(uint64_t a, uint64_t b, bool& saturated) {
+    uint64_t sum;
+    if (__builtin_add_overflow(a, b, &sum)) { saturated = true; return UINT64_MAX; }
+    return sum;
+}
+
+uint64_t mul_saturating(uint64_t a, uint64_t b, bool& saturated) {
+    uint64_t product;
+    if (__builtin_mul_overflow(a, b, &product)) { saturated = true; return UINT64_MAX; }
+    return product;
+}
+
+} // namespace
+
+// Completions below the same open spots with the same remaining options are
+// the same number however they were reached, so they are counted once
+struct ScheduleGenerator::CountMemo {
+    static constexpr size_t MAX_ENTRIES = 1 << 20;
+    const PackageTable* table = nullptr;         // the table the entries belong to
+    std::unordered_map<std::string, ScheduleCount> entries;
+    std::vector<std::vector<uint64_t>> weight;   // [spot][id]: real packages behind a representative
+    size_t hits = 0;
+    bool saturated = false;
+};
+
+ScheduleCount ScheduleGenerator::count_subtree(const PackageTable& table, const SearchControl& control,
+                                               SearchScratch& scratch, CountMemo& memo) const {
+    const CompatibilityIndex& compat = table.compat;
+    const size_t depth = scratch.depth;
+    const size_t num_spots = table.spots.size();
+    ++scratch.nodes_per_depth[depth];
+    ScheduleCount count;
+    if (depth == num_spots) {
+        count.schedules = count.time_signatures = 1;
+        return count;
+    }
+
+    const size_t spot = pick_spot(table, control, scratch);
+    const auto& domains = scratch.domains[depth];
+    auto& next_domains = scratch.domains[depth + 1];
+    const CompatibilityIndex::Word* options = domains.data() + control.word_offset[spot];
+
+    // Last open spot: every option left completes a schedule
+    if (depth + 1 == num_spots) {
+        CompatibilityIndex::for_each_bit(options, compat.words(spot), [&](size_t id) {
+            count.schedules = add_saturating(count.schedules, memo.weight[spot][id], memo.saturated);
+            ++count.time_signatures;
+        });
+        return count;
+    }
+
+    std::string key;
+    for (size_t open = 0; open < num_spots; ++open) {
+        if (scratch.chosen[open] != NO_PACKAGE) continue;
+        key.append(reinterpret_cast<const char*>(&open), sizeof open);
+        key.append(reinterpret_cast<const char*>(domains.data() + control.word_offset[open]),
+                   compat.words(open) * sizeof(CompatibilityIndex::Word));
+    }
+    auto cached = memo.entries.find(key);
+    if (cached != memo.entries.end()) {
+        ++memo.hits;
+        return cached->second;
+    }
+
+    CompatibilityIndex::for_each_bit(options, compat.words(spot), [&](size_t id) {
+        bool wiped_out = false;
+        for (size_t other = 0; other < num_spots && !wiped_out; ++other) {
+            if (other == spot || scratch.chosen[other] != NO_PACKAGE) continue;
+            const size_t offset = control.word_offset[other];
+            const CompatibilityIndex::Word* row = compat.row(spot, id, other);
+            CompatibilityIndex::Word any = 0;
+            for (size_t k = 0; k < compat.words(other); ++k) {
+                next_domains[offset + k] = domains[offset + k] & row[k];
+                any |= next_domains[offset + k];
+            }
+            wiped_out = any == 0;
         }
+        if (wiped_out) return;
+
+        scratch.chosen[spot] = static_cast<PackageId>(id);
+        scratch.depth = depth + 1;
+        ScheduleCount below = count_subtree(table, control, scratch, memo);
+        scratch.depth = depth;
+        scratch.chosen[spot] = NO_PACKAGE;
+
+        count.schedules = add_saturating(
+            count.schedules, mul_saturating(memo.weight[spot][id], below.schedules, memo.saturated),
+            memo.saturated);
+        count.time_signatures = add_saturating(count.time_signatures, below.time_signatures,
+                                               memo.saturated);
+    });
+
+    if (memo.entries.size() < CountMemo::MAX_ENTRIES) memo.entries.emplace(std::move(key), count);
+    return count;
+}
+
+void ScheduleGenerator::init_count(const PackageTable& table, SearchControl& control,
+                                   CountMemo& memo) const {
+    control.ordering = SpotOrdering::Dynamic;
+    init_control(table, control, 1);
+    load_domains(table, control, control.scratch[0]);
+    if (memo.table == &table) return;
+    memo.table = &table;
+    for (size_t spot = 0; spot < table.spots.size(); ++spot) {
+        memo.weight.emplace_back();
+        for (const auto& others : table.alternatives[spot]) memo.weight.back().push_back(1 + others.size());
+    }
+}
+
+ScheduleCount ScheduleGenerator::count_valid_schedules(const PackageTable& table,
+                                                       std::shared_ptr<CountMemo>* memo_out) {
+    auto count_start = std::chrono::high_resolution_clock::now();
+    ScheduleCount count;
+    if (table.spots.empty()) return count;
+
+    SearchControl control;
+    auto kept = std::make_shared<CountMemo>();
+    CountMemo& memo = *kept;
+    init_count(table, control, memo);
+    count = count_subtree(table, control, control.scratch[0], memo);
+    count.saturated = memo.saturated;
+
+    auto count_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - count_start).count();
+    std::cout << "Counted " << count.schedules << (count.saturated ? "+" : "") << " valid schedules ("
+              << count.time_signatures << " distinct time signatures) in " << count_ms << "ms, "
+              << memo.entries.size() << " memo entries, " << memo.hits << " memo hits" << std::endl;
+    if (memo_out) *memo_out = std::move(kept);
+    return count;
+}
+
+size_t ScheduleGenerator::sample_valid_schedules(const PackageTable& table,
+                                                 size_t samples,
+                                                 uint64_t seed,
+                                                 const ScheduleVisitor& visit,
+                                                 std::shared_ptr<CountMemo> kept) {
+    auto sample_start = std::chrono::high_resolution_clock::now();
+    if (table.spots.empty() || samples == 0) return 0;
+
+    const CompatibilityIndex& compat = table.compat;
+    const size_t num_spots = table.spots.size();
+    SearchControl control;
+    if (!kept || kept->table != &table) kept = std::make_shared<CountMemo>();   // another table's counts are no use
+    CountMemo& memo = *kept;
+    init_count(table, control, memo);
+    SearchScratch& scratch = control.scratch[0];
+    const ScheduleCount total = count_subtree(table, control, scratch, memo);
+    if (total.schedules == 0) return 0;
+
+    // Narrow the open spots below scratch.depth for `id` in `spot`; false if one runs dry
+    auto narrow = [&](size_t spot, size_t id) {
+        const auto& domains = scratch.domains[scratch.depth];
+        auto& next_domains = scratch.domains[scratch.depth + 1];
+        for (size_t other = 0; other < num_spots; ++other) {
+            if (other == spot || scratch.chosen[other] != NO_PACKAGE) continue;
+            const size_t offset = control.word_offset[other];
+            const CompatibilityIndex::Word* row = compat.row(spot, id, other);
+            CompatibilityIndex::Word any = 0;
+            for (size_t k = 0; k < compat.words(other); ++k) {
+                next_domains[offset + k] = domains[offset + k] & row[k];
+                any |= next_domains[offset + k];
+            }
+            if (!any) return false;
+        }
+        return true;
+    };
+
+    // Each draw walks down from the root, taking every option with
+    // probability (its real packages) x (completions below it), so every
+    // real schedule is equally likely (unless the counts saturated). The
+    // counts below come from the memo.
+    std::mt19937_64 rng(seed);
+    std::unordered_set<std::string> seen;
+    std::vector<std::pair<size_t, uint64_t>> choices;   // option, cumulative weight
+    size_t delivered = 0, draws = 0;
+    const size_t max_draws = 4 * samples + 64;          // duplicates get common near the space size
+    while (delivered < samples && draws < max_draws) {
+        ++draws;
+        std::fill(scratch.chosen.begin(), scratch.chosen.end(), NO_PACKAGE);
+        for (scratch.depth = 0; scratch.depth < num_spots; ++scratch.depth) {
+            const size_t depth = scratch.depth;
+            const size_t spot = pick_spot(table, control, scratch);
+            const CompatibilityIndex::Word* options = scratch.domains[depth].data() + control.word_offset[spot];
+
+            choices.clear();
+            uint64_t weight_sum = 0;
+            CompatibilityIndex::for_each_bit(options, compat.words(spot), [&](size_t id) {
+                uint64_t below = 1;
+                if (depth + 1 < num_spots) {
+                    if (!narrow(spot, id)) return;
+                    scratch.chosen[spot] = static_cast<PackageId>(id);
+                    scratch.depth = depth + 1;
+                    below = count_subtree(table, control, scratch, memo).schedules;
+                    scratch.depth = depth;
+                    scratch.chosen[spot] = NO_PACKAGE;
+                }
+                weight_sum = add_saturating(weight_sum,
+                                            mul_saturating(memo.weight[spot][id], below, memo.saturated),
+                                            memo.saturated);
+                if (below > 0) choices.emplace_back(id, weight_sum);
+            });
+
+            const uint64_t pick = std::uniform_int_distribution<uint64_t>(0, weight_sum - 1)(rng);
+            const size_t id = std::upper_bound(choices.begin(), choices.end(), pick,
+                [](uint64_t value, const std::pair<size_t, uint64_t>& choice) {
+                    return value < choice.second;
+                })->first;
+            narrow(spot, id);
+            scratch.chosen[spot] = static_cast<PackageId>(id);
+        }
+
+        std::string key(reinterpret_cast<const char*>(scratch.chosen.data()),
+                        scratch.chosen.size() * sizeof(PackageId));
+        if (!seen.insert(std::move(key)).second) continue;
+        ++delivered;
+        if (!visit(scratch.chosen, 0)) break;
     }
+
+    auto sample_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - sample_start).count();
+    std::cout << "Sampled " << delivered << " distinct schedules in " << draws << " draws from "
+              << total.schedules << (memo.saturated ? "+" : "") << " valid schedules (seed " << seed
+              << ") in " << sample_ms << "ms"
+              << (memo.saturated ? ", counts saturated so draws are only roughly uniform" : "") << std::endl;
+    return delivered;
+}
+
+std::vector<Schedule> ScheduleGenerator::generate_all_valid_schedules(
+    const std::vector<std::vector<std::string>>& class_spots,
+    const UserPreferences& prefs,
+    int limit) {
+
+    std::vector<Schedule> valid_schedules;
+    auto table = prepare_packages(class_spots, prefs);
+    if (!table) return valid_schedules;
+
+    std::mutex results_mutex;
+    for_each_valid_schedule(*table,
+        [&](const PackedSchedule& schedule, unsigned) {
+            std::lock_guard<std::mutex> lock(results_mutex);
+            size_t room = static_cast<size_t>(limit) - valid_schedules.size();
+            for (auto& full : table->expand(schedule, room)) valid_schedules.push_back(std::move(full));
+            return valid_schedules.size() < static_cast<size_t>(limit);
+        },
+        0, static_cast<size_t>(limit));
     return valid_schedules;
 }
 
-Schedule ScheduleGenerator::create_pooled_schedule(size_t reserve_size) {
-    // Create a PMR vector using our memory resource
-    Schedule schedule(schedule_pool.get());
-    schedule.reserve(reserve_size);
+Schedule PackageTable::materialize(const PackedSchedule& ids) const {
+    Schedule schedule;
+    schedule.reserve(ids.size());
+    for (size_t spot = 0; spot < ids.size(); ++spot) {
+        schedule.push_back(package(spot, ids[spot]));
+    }
     return schedule;
 }
 
-Schedule ScheduleGenerator::copy_schedule_pooled(const Schedule& src) {
-    // Create a new schedule in the pool
-    Schedule new_schedule(schedule_pool.get());
-    new_schedule.reserve(src.size() + 1);
-    
-    // Copy all items from source schedule
-    for (const auto& item : src) {
-        new_schedule.push_back(item);
-    }
-    
-    return new_schedule;
+size_t PackageTable::multiplicity(const PackedSchedule& ids) const {
+    size_t count = 1;
+    for (size_t spot = 0; spot < ids.size(); ++spot) count *= 1 + alternatives[spot][ids[spot]].size();
+    return count;
 }
 
-// Helper: returns true if schedule fills all spots and all required section types for each class
-bool is_valid_schedule(const Schedule& schedule, const std::vector<std::vector<std::string>>& class_spots, DatabaseConnection* db) {
-    // 1. Each spot must be filled by exactly one class from that spot
-    if (schedule.size() != class_spots.size()) return false;
-    for (size_t spot_idx = 0; spot_idx < class_spots.size(); ++spot_idx) {
-        const auto& item = schedule[spot_idx];
-        // Must match a class in this spot
-        if (std::find(class_spots[spot_idx].begin(), class_spots[spot_idx].end(), item.class_code) == class_spots[spot_idx].end())
-            return false;
+std::vector<Schedule> PackageTable::expand(const PackedSchedule& ids, size_t limit, size_t skip) const {
+    std::vector<Schedule> out;
+    if (skip >= multiplicity(ids)) return out;
 
-        // 2. For each class, must have all required section types
-        // You may already have a function for this, but here's a generic version:
-        std::set<std::string> required_types = db->get_required_section_types(item.class_code);
-        std::set<std::string> present_types;
-        for (const auto& section : item.sections) {
-            present_types.insert(section.get_section_type());
+    // Mixed-radix digits of `skip`, first spot fastest (same order as the odometer)
+    std::vector<size_t> pick(ids.size(), 0);   // 0 = representative, k = alternative k-1
+    for (size_t spot = 0; spot < ids.size(); ++spot) {
+        size_t radix = 1 + alternatives[spot][ids[spot]].size();
+        pick[spot] = skip % radix;
+        skip /= radix;
+    }
+    while (out.size() < limit) {
+        Schedule schedule;
+        schedule.reserve(ids.size());
+        for (size_t spot = 0; spot < ids.size(); ++spot) {
+            schedule.push_back(pick[spot] == 0 ? package(spot, ids[spot])
+                                               : alternatives[spot][ids[spot]][pick[spot] - 1]);
         }
-        for (const auto& req : required_types) {
-            if (present_types.count(req) == 0) return false;
+        out.push_back(std::move(schedule));
+
+        /* odometer */
+        size_t spot = 0;
+        for (; spot < ids.size(); ++spot) {
+            if (++pick[spot] <= alternatives[spot][ids[spot]].size()) break;
+            pick[spot] = 0;
         }
+        if (spot == ids.size()) break;
+    }
+    return out;
+}
+
+// Helper: true if the package belongs to its spot and has every required section type
+bool is_complete_package(const ScheduleItem& item,
+                         const std::vector<std::string>& spot_classes,
+                         const std::set<std::string>& required_types) {
+    // Must match a class in this spot
+    if (std::find(spot_classes.begin(), spot_classes.end(), item.class_code) == spot_classes.end())
+        return false;
+
+    // Must have all required section types
+    std::set<std::string> present_types;
+    for (const auto& section : item.sections) {
+        present_types.insert(section.get_section_type());
+    }
+    for (const auto& req : required_types) {
+        if (present_types.count(req) == 0) return false;
     }
     return true;
-}
\ No newline at end of file
+}
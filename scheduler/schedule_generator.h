@@ -1,10 +1,19 @@
 #pragma once
-#include "database.h"
+#include "catalog_source.h"
 #include "section.h"
 #include "user_preferences.h"
+#include "week_mask.h"
+#include "compatibility_index.h"
+#include "work_stealing_pool.h"
 #include <vector>
 #include <string>
+#include <map>
+#include <set>
 #include <memory>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory_resource> // For PMR containers
 
 // Define our new struct to replace the tuple
@@ -13,57 +22,298 @@ struct ScheduleItem {
     std::string class_code;
     int pkg_idx;
     std::vector<Section> sections;
+    WeekMask occupancy;   // union of the sections' meeting slots, compiled once
     
     // Default constructor
     ScheduleItem() : spot_idx(0), pkg_idx(0) {}
     
     // Full constructor
     ScheduleItem(int spot, std::string code, int pkg, std::vector<Section> secs)
-        : spot_idx(spot), class_code(std::move(code)), pkg_idx(pkg), sections(std::move(secs)) {}
+        : spot_idx(spot), class_code(std::move(code)), pkg_idx(pkg), sections(std::move(secs)),
+          occupancy(WeekMask::of(sections)) {}
 };
 
 // Use PMR vector for memory pooling
 using Schedule = std::pmr::vector<ScheduleItem>;
 using SpotOptions = std::vector<ScheduleItem>; // Keep this as standard vector
 
+// Compact schedule used inside the search and scoring: entry i is the index
+// of the chosen package in PackageTable::spots[i], always in the order the
+// user listed the spots. Full ScheduleItems are only rebuilt from the
+// PackageTable for the final results.
+using PackageId = uint32_t;
+using PackedSchedule = std::vector<PackageId>;
+
+// Entry of a partial PackedSchedule whose spot the search has not filled yet
+constexpr PackageId NO_PACKAGE = UINT32_MAX;
+
+// Immutable per-request package table that packed schedules point into.
+// Packages of a spot that only differ in section numbers (same class, and
+// per section the same type, days, times and instructor) are collapsed into
+// one time-signature class: the search and scoring see one representative,
+// and the others are brought back only when final results are expanded.
+struct PackageTable {
+    std::vector<std::vector<std::string>> class_spots;
+    std::vector<SpotOptions> spots;        // spots[i][id] is the representative of class `id`
+    std::vector<std::vector<SpotOptions>> alternatives;   // [i][id]: the class's other packages
+    std::map<std::string, std::set<std::string>> required_types;   // per class code, from its sections
+    CompatibilityIndex compat;
+    // [i]: packages of spot i that fit at least one live package of every
+    // other spot (arc consistency); only these are ever searched
+    std::vector<std::vector<CompatibilityIndex::Word>> live;
+
+    const ScheduleItem& package(size_t spot, PackageId id) const { return spots[spot][id]; }
+
+    // Representatives only
+    Schedule materialize(const PackedSchedule& ids) const;
+
+    // Number of real schedules a packed schedule of representatives stands for
+    size_t multiplicity(const PackedSchedule& ids) const;
+
+    // The real schedules behind `ids` (representatives first), at most
+    // `limit`, starting with the `skip`-th one
+    std::vector<Schedule> expand(const PackedSchedule& ids, size_t limit, size_t skip = 0) const;
+};
+
+// A packed schedule seen as a range of the ScheduleItems it points to, so the
+// evaluator can walk it like a Schedule without copying anything
+class PackedScheduleView {
+public:
+    PackedScheduleView(const PackageTable& table, const PackedSchedule& ids)
+        : table_(&table), ids_(&ids) {}
+
+    class iterator {
+    public:
+        iterator(const PackedScheduleView* view, size_t spot) : view_(view), spot_(spot) {}
+        const ScheduleItem& operator*() const { return view_->table_->package(spot_, (*view_->ids_)[spot_]); }
+        const ScheduleItem* operator->() const { return &**this; }
+        iterator& operator++() { ++spot_; return *this; }
+        bool operator!=(const iterator& other) const { return spot_ != other.spot_; }
+        bool operator==(const iterator& other) const { return spot_ == other.spot_; }
+    private:
+        const PackedScheduleView* view_;
+        size_t spot_;
+    };
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, ids_->size()); }
+    size_t size() const { return ids_->size(); }
+    bool empty() const { return ids_->empty(); }
+
+private:
+    const PackageTable* table_;
+    const PackedSchedule* ids_;
+};
+
+// Receives every complete, valid schedule as soon as the search finds it.
+// `worker` is the index of the search thread (0 .. num_workers-1), so callers
+// can keep per-thread state without locking. Return false to stop the search.
+using ScheduleVisitor = std::function<bool(const PackedSchedule& schedule, unsigned worker)>;
+
+// Optional pruning hook, asked before a partial schedule (one entry per spot,
+// NO_PACKAGE where nothing is chosen yet; complete schedules included) is
+// expanded. Return false to skip it and everything below it.
+using SubtreeFilter = std::function<bool(const PackedSchedule& partial, unsigned worker)>;
+
+// Handed the section groups of every fetched class as soon as they arrive,
+// before any package is built from them, so dependent lookups can start early
+using SectionsFetched = std::function<void(const std::map<std::string, std::vector<std::vector<Section>>>& catalog)>;
+
+// Which spot the search fills next
+enum class SpotOrdering {
+    AsListed,          // the order of --class-spots
+    MostConstrained,   // fewest usable packages first, fixed for the whole search
+    Dynamic            // at every node, the spot with the fewest options left
+};
+
+// Counters from the last for_each_valid_schedule call
+struct SearchStats {
+    std::vector<size_t> nodes_per_depth;   // partial schedules reached with d spots filled
+    size_t schedules = 0;
+    size_t pruned = 0;
+    size_t splits = 0;
+    size_t wipeouts = 0;   // choices skipped because they left some open spot without options
+};
+
+// Number of complete schedules for a PackageTable, counted without building any
+struct ScheduleCount {
+    uint64_t schedules = 0;         // real schedules, every section alternative included
+    uint64_t time_signatures = 0;   // distinct schedules of representatives
+    bool saturated = false;         // the true count exceeds UINT64_MAX
+};
+
+// What the arc-consistency pass took out of a PackageTable
+struct PropagationStats {
+    size_t packages_removed = 0;   // representatives with no support in some spot
+    size_t classes_removed = 0;    // class codes left without any package in their spot
+    size_t revisions = 0;          // spot-pair revisions until the fixpoint
+};
+
 class ScheduleGenerator {
+public:
+    // Memoized subtree counts of one table, see count_valid_schedules
+    struct CountMemo;
+
 private:
-    std::shared_ptr<DatabaseConnection> db;
-    
-    // Memory pool for schedules
-    std::unique_ptr<std::pmr::synchronized_pool_resource> schedule_pool;
-    std::pmr::polymorphic_allocator<ScheduleItem> item_allocator;
+    // Per-worker search state: the one partial schedule plus, per depth, the
+    // options of every open spot still compatible with everything chosen so
+    // far (all spots' bitsets back to back, see SearchControl::word_offset)
+    struct SearchScratch {
+        unsigned worker = 0;
+        PackedSchedule chosen;
+        size_t depth = 0;                 // spots filled in `chosen`
+        std::vector<std::vector<CompatibilityIndex::Word>> domains;
+        std::vector<size_t> nodes_per_depth;
+        size_t wipeouts = 0;
+    };
+
+    // Shared between the search workers of one for_each_valid_schedule call
+    struct SearchControl {
+        std::atomic<size_t> emitted{0};
+        std::atomic<bool> stopped{false};
+        std::atomic<size_t> pruned{0};
+        std::atomic<size_t> splits{0};
+        size_t limit = 0;
+        const SubtreeFilter* keep = nullptr;
+        WorkStealingPool* pool = nullptr;
+        std::vector<SearchScratch> scratch;   // indexed by worker
+
+        SpotOrdering ordering = SpotOrdering::Dynamic;
+        std::vector<size_t> word_offset;      // first word of each spot in a domain row
+        std::vector<CompatibilityIndex::Word> initial;   // live packages per spot
+        std::vector<size_t> static_order;     // spots, most constrained first
+    };
+
+    std::shared_ptr<CatalogSource> db;
+    std::unique_ptr<WorkStealingPool> pool;   // kept across searches, resized on demand
+
+    // Last prepared table and its spot keys: when the next request adds,
+    // removes or swaps a spot, the unchanged spots and their pairwise
+    // compatibility are reused instead of refetched and retested. A key
+    // names the source (semester) too, and a spot is refetched once it is
+    // older than spot_ttl, so seat counts and full sections stay current.
+    std::shared_ptr<const PackageTable> previous;
+    std::vector<std::string> previous_keys;
+    std::vector<std::chrono::steady_clock::time_point> previous_fetched;   // per spot
+    std::chrono::seconds spot_ttl{60};
+    SpotOrdering ordering = SpotOrdering::Dynamic;
+    SearchStats stats;
+    PropagationStats propagation;
     
     // Helper methods
-    bool packages_conflict(const std::vector<Section>& pkg1, 
-                          const std::vector<Section>& pkg2) const;
+    bool packages_conflict(const ScheduleItem& pkg1, 
+                          const ScheduleItem& pkg2) const;
     
+    // Only complete packages are produced; the section types each class
+    // requires are derived from its fetched groups into `required_types`
     std::vector<SpotOptions> prepare_spot_options(
         const std::vector<std::vector<std::string>>& class_spots,
-        const UserPreferences& prefs = UserPreferences());
+        std::map<std::string, std::set<std::string>>& required_types,
+        const UserPreferences& prefs = UserPreferences(),
+        const SectionsFetched& fetched = nullptr);
     
-    void extend_schedules(const std::vector<Schedule>& current_schedules,
-                         const SpotOptions& next_options,
-                         std::vector<Schedule>& result,
-                         int spot_idx,
-                         int limit);
-                         
-    // Memory pooled schedule creation methods
-    Schedule create_pooled_schedule(size_t reserve_size);
-    Schedule copy_schedule_pooled(const Schedule& src);
-
-    // Precompute compatibility between schedules and options
-    std::vector<std::vector<bool>> precompute_compatibility_matrix(
-        const std::vector<Schedule>& schedules,
-        const SpotOptions& options,
-        int spot_idx);
+    // True if two packages can share a schedule (different class, no time clash)
+    bool packages_compatible(const ScheduleItem& pkg1, const ScheduleItem& pkg2) const;
+
+    // Keep one package per time signature in `spot`; returns the others,
+    // per kept package (PackageTable::alternatives)
+    std::vector<SpotOptions> collapse_equivalent_packages(SpotOptions& spot) const;
+
+    // Package-pair compatibility between every pair of spots. Pairs of
+    // spots reused from `previous` (reused_from[i] = its spot there, or -1)
+    // are copied instead of tested.
+    CompatibilityIndex build_compatibility_index(const std::vector<SpotOptions>& spots,
+                                                 const std::vector<int>& reused_from,
+                                                 const PackageTable* previous) const;
+
+    // AC-3 over the compatibility index: fill table.live by dropping every
+    // package that has no compatible live package in some other spot, until
+    // nothing changes
+    PropagationStats enforce_arc_consistency(PackageTable& table) const;
+
+    // Depth-first backtracking below scratch.chosen; returns false once the search must stop.
+    // While other workers are idle, sibling subtrees are handed to the pool instead.
+    bool search_subtree(const PackageTable& table, const ScheduleVisitor& visit,
+                        SearchScratch& scratch, SearchControl& control);
+
+    // Rebuild scratch.domains[scratch.depth] from scratch.chosen
+    void load_domains(const PackageTable& table, const SearchControl& control,
+                      SearchScratch& scratch) const;
+
+    // Next open spot to fill, according to control.ordering
+    size_t pick_spot(const PackageTable& table, const SearchControl& control,
+                     const SearchScratch& scratch) const;
+
+    // Word offsets, live domains, static order and num_workers scratches
+    void init_control(const PackageTable& table, SearchControl& control, unsigned num_workers) const;
+
+    // Completions below scratch.chosen, memoized on the open spots' options
+    ScheduleCount count_subtree(const PackageTable& table, const SearchControl& control,
+                                SearchScratch& scratch, CountMemo& memo) const;
+    // Single-scratch control at the root plus the per-package weights (kept
+    // if `memo` already has them)
+    void init_count(const PackageTable& table, SearchControl& control, CountMemo& memo) const;
+
+    // Pool task: search everything below `prefix` on `worker`'s scratch
+    void search_task(const PackageTable& table, const ScheduleVisitor& visit,
+                     SearchControl& control, const PackedSchedule& prefix, unsigned worker);
 
 public:
-    ScheduleGenerator(std::shared_ptr<DatabaseConnection> db);
+    ScheduleGenerator(std::shared_ptr<CatalogSource> db);
     
+    // Fetch sections and build the per-request package table (complete
+    // packages, required types per class and the compatibility index).
+    // Spots unchanged since the previous call, and fetched less than the
+    // reuse ttl ago, are reused from it (and not passed to `fetched`). Null
+    // if some spot has no usable package.
+    std::shared_ptr<const PackageTable> prepare_packages(
+        const std::vector<std::vector<std::string>>& class_spots,
+        const UserPreferences& prefs = UserPreferences(),
+        const SectionsFetched& fetched = nullptr);
+
+    // Stream every valid schedule to `visit` without materialising the search
+    // space: each worker keeps a single partial schedule and backtracks, and
+    // subtrees are split off to idle workers through a work-stealing pool.
+    // num_workers == 0 means one per hardware thread. Returns the number of
+    // schedules delivered (at most `limit`). With a `keep` filter, subtrees
+    // it rejects are skipped, so only the schedules it lets through count.
+    size_t for_each_valid_schedule(
+        const PackageTable& table,
+        const ScheduleVisitor& visit,
+        unsigned num_workers = 0,
+        size_t limit = 10000000,
+        const SubtreeFilter& keep = nullptr);
+
+    // Exact number of valid schedules, without enumerating or building them:
+    // the last open spot is summed from its option bitset and subtrees with
+    // identical remaining options are counted once. With `memo_out`, the
+    // memo is handed back for sample_valid_schedules on the same table.
+    ScheduleCount count_valid_schedules(const PackageTable& table,
+                                        std::shared_ptr<CountMemo>* memo_out = nullptr);
+
+    // Up to `samples` distinct valid schedules drawn uniformly at random over
+    // the real schedules they stand for (so a representative with more
+    // alternatives is drawn more often), handed to `visit` on worker 0.
+    // Deterministic for a given seed. Bounded at 4 * samples + 64 draws, so
+    // fewer come back when the space is barely larger than `samples`.
+    // `memo` from count_valid_schedules on this table spares counting it
+    // again. Past UINT64_MAX schedules (ScheduleCount::saturated) the branch
+    // weights are clamped, so the draws are no longer exactly uniform; they
+    // still favour larger subtrees.
+    size_t sample_valid_schedules(const PackageTable& table, size_t samples, uint64_t seed,
+                                  const ScheduleVisitor& visit,
+                                  std::shared_ptr<CountMemo> memo = nullptr);
+
+    void set_spot_ordering(SpotOrdering order) { ordering = order; }
+    // How long fetched sections may be reused by later calls (default 60s;
+    // 0 refetches every spot every call)
+    void set_spot_reuse_ttl(std::chrono::seconds ttl) { spot_ttl = ttl; }
+    const SearchStats& last_search_stats() const { return stats; }
+    const PropagationStats& last_propagation_stats() const { return propagation; }
+
     // Generate all valid schedules from the class spots
     std::vector<Schedule> generate_all_valid_schedules(
         const std::vector<std::vector<std::string>>& class_spots,
         const UserPreferences& prefs = UserPreferences(),
         int limit = 10000000);
-};
\ No newline at end of file
+};
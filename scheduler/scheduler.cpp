@@ -10,6 +10,9 @@
 #include <atomic>
 #include <chrono>
 #include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "score_bound.h"
 
 // Helper function for clamping values since std::clamp is C++17
 template<typename T>
@@ -17,8 +20,29 @@ T clamp(const T& value, const T& low, const T& high) {
     return value < low ? low : (value > high ? high : value);
 }
 
-Scheduler::Scheduler(std::shared_ptr<DatabaseConnection> db, bool silent_mode) 
-    : db_(db), silent_mode_(silent_mode), generator(db), evaluator(db) {
+Scheduler::Scheduler(std::shared_ptr<CatalogSource> db, bool silent_mode) 
+    : db_(db),
+      pool_(std::make_shared<ConnectionPool>(db, 1, true)),
+      silent_mode_(silent_mode), generator(db), evaluator(db) {
+}
+
+void Scheduler::set_rating_cache(size_t capacity, std::chrono::seconds ttl, std::string file) {
+    rating_cache_ = RatingCache(capacity, ttl);
+    rating_cache_file_ = std::move(file);
+    if (rating_cache_file_.empty()) return;
+    size_t loaded = rating_cache_.load(rating_cache_file_);
+    if (!silent_mode_) {
+        std::cout << "Read " << loaded << " professor ratings from " << rating_cache_file_ << "\n";
+    }
+}
+
+CatalogSource::ProfessorRating Scheduler::professor_rating(const std::string& instructor,
+                                                          const std::string& class_code) {
+    RatingCache::Key key{instructor, class_code};
+    if (const auto* hit = rating_cache_.find(key)) return *hit;
+    CatalogSource::ProfessorRating rating = db_->get_professor_ratings(instructor, class_code);
+    rating_cache_.put(key, rating);
+    return rating;
 }
 
 std::vector<std::pair<Schedule, double>> Scheduler::build_schedule(
@@ -26,163 +50,264 @@ std::vector<std::pair<Schedule, double>> Scheduler::build_schedule(
     const UserPreferences& user_prefs,
     int top_n,
     bool silent) {
+    ScheduleCursor next;
+    return build_schedule_page(class_spots, user_prefs, top_n, ScheduleCursor(), next, silent);
+}
+
+ScheduleCount Scheduler::count_schedules(
+    const std::vector<std::vector<std::string>>& class_spots,
+    const UserPreferences& user_prefs) {
+    auto table = generator.prepare_packages(class_spots, user_prefs);
+    if (!table) return ScheduleCount();
+    return generator.count_valid_schedules(*table);
+}
+
+std::vector<std::pair<Schedule, double>> Scheduler::build_schedule_page(
+    const std::vector<std::vector<std::string>>& class_spots,
+    const UserPreferences& user_prefs,
+    int top_n,
+    const ScheduleCursor& after,
+    ScheduleCursor& next,
+    bool silent) {
     if (silent) silent_mode_ = false;
-    
-    if (!silent_mode_) {
-        std::cout << "Generating all valid schedules from " << class_spots.size() << " spots...\n";
+
+    const uint64_t sample_key = sample_budget_ == 0 ? 0 : sample_budget_ * 1000003ull ^ sample_seed_;
+    const uint64_t fingerprint = ScheduleCursor::fingerprint_of(class_spots, user_prefs, db_->source_id(),
+                                                                sample_key);
+    if (after.started && after.fingerprint != fingerprint) {
+        throw std::invalid_argument("schedule cursor was issued for a different request");
     }
-    
-    // Generate all valid schedules
-    auto all_schedules = generator.generate_all_valid_schedules(class_spots, user_prefs);
+    next = after;
+    next.fingerprint = fingerprint;
+    if (after.exhausted) return {};
     
     if (!silent_mode_) {
-        std::cout << "Found " << all_schedules.size() << " valid schedules\n";
+        std::cout << "Generating and scoring valid schedules from " << class_spots.size() << " spots...\n";
     }
     
-    if (all_schedules.empty()) {
+    // Scoring runs inside the search workers, so schedules are scored as they
+    // are found and only the current top_n per worker are ever kept in memory.
+    unsigned num_threads = std::max(1u, std::thread::hardware_concurrency());
+    
+    // Ratings for the fetched sections load on a pooled connection while the
+    // packages are built from them (no query of the build needs db_ after
+    // the hook, so the default pool lends db_ itself); package_ratings below
+    // only has to fetch what this missed
+    std::future<ScheduleEvaluator::RatingMap> prefetch;
+    auto prefetch_ratings = [&](const std::map<std::string, std::vector<std::vector<Section>>>& catalog) {
+        auto missing = ScheduleEvaluator::missing_ratings(catalog, rating_cache_);
+        if (missing.empty()) return;
+        prefetch = std::async(std::launch::async, [this, missing = std::move(missing)] {
+            // Only a head start: if it fails (e.g. no connection to spare),
+            // package_ratings fetches everything on the main connection
+            try {
+                ConnectionPool::Lease lease = pool_->acquire();
+                return ScheduleEvaluator(lease.connection()).fetch_ratings(missing);
+            } catch (const std::exception& e) {
+                std::cerr << "Rating prefetch failed, fetching with the request instead: "
+                          << e.what() << std::endl;
+                return ScheduleEvaluator::RatingMap();
+            }
+        });
+    };
+
+    // Schedules travel as package-id tuples; only the final top_n are
+    // materialized into ScheduleItems.
+    std::shared_ptr<const PackageTable> table =
+        generator.prepare_packages(class_spots, user_prefs, prefetch_ratings);
+    ScheduleEvaluator::RatingMap prefetched;
+    if (prefetch.valid()) prefetched = prefetch.get();
+    if (!table) {
         if (!silent_mode_) {
             std::cout << "No valid schedules found!\n";
         }
         return {};
     }
-    
-    if (!silent_mode_) {
-        std::cout << "Scoring schedules...\n";
+
+    // Too many schedules for the budget: score a uniform sample of them
+    bool sampling = false;
+    std::shared_ptr<ScheduleGenerator::CountMemo> count_memo;   // reused by the sampler
+    if (sample_budget_ > 0) {
+        ScheduleCount count = generator.count_valid_schedules(*table, &count_memo);
+        sampling = count.saturated || count.time_signatures > sample_budget_;
     }
-    
-    // Get the number of available hardware threads (cores)
-    unsigned int num_threads = std::thread::hardware_concurrency();
-    // Ensure at least 2 threads, but not more than needed
-    num_threads = std::max(2u, std::min(num_threads, 
-                          static_cast<unsigned int>(all_schedules.size() / 1000 + 1)));
-    
-    if (!silent_mode_) {
-        std::cout << "Using " << num_threads << " threads for parallel schedule evaluation\n";
+
+    // Ranking order shared with ScheduleCursor: score, then package ids, so
+    // ties come out the same on every run and pages never overlap
+    struct ScoredSchedule {
+        double score;
+        PackedSchedule ids;
+        size_t first;    // first expansion not returned by an earlier page
+    };
+    auto better = [](const ScoredSchedule& a, const ScoredSchedule& b) {
+        return a.score > b.score || (a.score == b.score && a.ids < b.ids);
+    };
+    auto heap_order = better; // Min heap (keeping the worst schedule on top)
+
+    // Every rating the request can use, laid out per package: the workers
+    // below score without touching the database
+    ScheduleEvaluator::PackageRatings ratings;
+    {
+        auto rating_start = std::chrono::high_resolution_clock::now();
+        RatingCache::Stats before = rating_cache_.stats();
+        ConnectionPool::Lease lease = pool_->acquire();
+        ratings = ScheduleEvaluator(lease.connection()).package_ratings(*table, rating_cache_, prefetched);
+        lease.reset();
+        size_t hits = rating_cache_.stats().hits - before.hits;
+        size_t misses = rating_cache_.stats().misses - before.misses;
+        if (misses > 0 && !rating_cache_file_.empty() && !rating_cache_.save(rating_cache_file_)) {
+            std::cerr << "✖ Could not save the rating cache to " << rating_cache_file_ << std::endl;
+        }
+        if (!silent_mode_) {
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::high_resolution_clock::now() - rating_start).count();
+            long rate = hits + misses ? std::lround(100.0 * hits / (hits + misses)) : 0;
+            std::cout << "Professor ratings: " << hits << " cached, " << misses << " fetched ("
+                      << rate << "% hit rate), " << elapsed << "ms after packages" << std::endl;
+        }
     }
-    
-    // Shared data structures need mutex protection
-    std::mutex top_schedules_mutex;
-    
-    // Min heap to store only the top_n schedules
-    // We use negative scores to make it a max heap for highest scores
-    std::priority_queue<
-        std::pair<double, Schedule>,
-        std::vector<std::pair<double, Schedule>>,
-        std::function<bool(const std::pair<double, Schedule>&, const std::pair<double, Schedule>&)>
-    > top_schedules([](const auto& a, const auto& b) {
-        return a.first > b.first; // Min heap (keeping lowest scores)
-    });
+
+    // Branch-and-bound: once some worker holds top_n schedules, its worst
+    // score is a floor for the final top_n, and any subtree whose optimistic
+    // score falls below that floor cannot contribute
+    std::unique_ptr<ScoreBound> bound;
+    if (!exhaustive_search_ && !sampling) {
+        bound = std::make_unique<ScoreBound>(*table, user_prefs, evaluator, ratings);
+    }
+    std::atomic<double> threshold(-std::numeric_limits<double>::infinity());
+    auto raise_threshold = [&](double score) {
+        double current = threshold.load(std::memory_order_relaxed);
+        while (score > current &&
+               !threshold.compare_exchange_weak(current, score, std::memory_order_relaxed)) {}
+    };
+    SubtreeFilter keep;
+    if (bound) {
+        keep = [&](const PackedSchedule& partial, unsigned) {
+            double best = ScheduleEvaluator::normalize_score(bound->upper_bound(partial));
+            return best >= threshold.load(std::memory_order_relaxed) - 1e-9;
+        };
+    }
+
+    // Per-worker state: no locking needed on the hot path
+    struct WorkerState {
+        std::vector<ScoredSchedule> top; // heap ordered by heap_order
+        size_t represented = 0;          // real schedules behind the packed ones seen
+    };
+    std::vector<WorkerState> workers(num_threads);
     
     // For time tracking
+    std::mutex progress_mutex;
     std::atomic<int> progress(0);
     auto start_time = std::chrono::high_resolution_clock::now();
     auto last_checkpoint = start_time;
     
-    // Worker function that each thread will execute
-    auto worker_function = [&](size_t start_idx, size_t end_idx) {
-        // Each thread needs a proper database connection with parameters
-        auto thread_db = std::make_shared<DatabaseConnection>(
-            db_->get_db_name(),     // Add a getter in DatabaseConnection class
-            db_->get_user(),        // Add a getter in DatabaseConnection class
-            db_->get_password(),    // Add a getter in DatabaseConnection class
-            db_->get_host(),        // Add a getter in DatabaseConnection class
-            db_->get_port(),        // Add a getter in DatabaseConnection class
-            db_->get_semester()     // Add a getter in DatabaseConnection class
-        );
-        auto thread_evaluator = ScheduleEvaluator(thread_db);
+    auto score_schedule = [&](const PackedSchedule& schedule, unsigned worker) {
+        WorkerState& state = workers[worker];
+        size_t count = table->multiplicity(schedule);
+        state.represented += count;
         
-        // Each thread gets its own cache to avoid contention
-        std::map<std::pair<std::string, std::string>, DatabaseConnection::ProfessorRating> local_cache;
+        double score = evaluator.evaluate_packed(*table, schedule, user_prefs, ratings);
         
-        // Process a subset of schedules
-        for (size_t i = start_idx; i < end_idx && i < all_schedules.size(); ++i) {
-            const auto& schedule = all_schedules[i];
-            
-            // Evaluate this schedule using thread-local evaluator and cache
-            double score = thread_evaluator.evaluate_schedule_with_cache(
-                schedule, user_prefs, false, local_cache);
-            
-            // Thread-safe update of the shared top schedules
-            {
-                std::lock_guard<std::mutex> lock(top_schedules_mutex);
-                if (top_schedules.size() < static_cast<size_t>(top_n)) {
-                    top_schedules.emplace(score, schedule);
-                } 
-                else if (score > top_schedules.top().first) {
-                    top_schedules.pop();
-                    top_schedules.emplace(score, schedule);
-                }
+        // Skip whatever earlier pages already returned. They still had to
+        // be found and scored: nothing bounds a subtree's score from below,
+        // so later pages cost more
+        ScoredSchedule entry{score, schedule, after.first_unreturned(score, schedule, count)};
+        if (entry.first < count) {
+            if (state.top.size() < static_cast<size_t>(top_n)) {
+                state.top.push_back(std::move(entry));
+                std::push_heap(state.top.begin(), state.top.end(), heap_order);
+            } else if (better(entry, state.top.front())) {
+                std::pop_heap(state.top.begin(), state.top.end(), heap_order);
+                state.top.back() = std::move(entry);
+                std::push_heap(state.top.begin(), state.top.end(), heap_order);
             }
+            if (state.top.size() == static_cast<size_t>(top_n)) raise_threshold(state.top.front().score);
+        }
+        
+        // Update progress counter
+        int current_progress = ++progress;
+        if (current_progress % 1000 == 0 && !silent_mode_) {
+            // Thread-safe output of progress
+            std::lock_guard<std::mutex> lock(progress_mutex);
+            auto current_time = std::chrono::high_resolution_clock::now();
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                current_time - last_checkpoint).count();
+            auto total_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                current_time - start_time).count();
             
-            // Update progress counter
-            int current_progress = ++progress;
-            if (current_progress % 1000 == 0) {
-                // Thread-safe output of progress
-                std::lock_guard<std::mutex> lock(top_schedules_mutex);
-                auto current_time = std::chrono::high_resolution_clock::now();
-                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    current_time - last_checkpoint).count();
-                auto total_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    current_time - start_time).count();
-                
-                if (!silent_mode_) {
-                    std::cout << "Processed " << current_progress << "/" << all_schedules.size() 
-                            << " schedules (" << (current_progress * 100 / all_schedules.size()) << "%)"
-                            << " - Last 1000: " << elapsed << "ms"
-                            << " - Avg per schedule: " << (elapsed / 1000.0) << "ms"
-                            << " - Total: " << total_elapsed << "ms"
-                            << std::endl;
-                }
-                
-                last_checkpoint = current_time;
-            }
+            std::cout << "Processed " << current_progress << " schedules"
+                    << " - Last 1000: " << elapsed << "ms"
+                    << " - Avg per schedule: " << (elapsed / 1000.0) << "ms"
+                    << " - Total: " << total_elapsed << "ms"
+                    << std::endl;
+            
+            last_checkpoint = current_time;
         }
+        return true;
     };
     
-    // Launch threads
-    std::vector<std::future<void>> futures;
-    size_t chunk_size = (all_schedules.size() + num_threads - 1) / num_threads; // Ceiling division
+    size_t total_schedules = sampling
+        ? generator.sample_valid_schedules(*table, sample_budget_,
+                                           sample_seed_ != 0 ? sample_seed_ : fingerprint, score_schedule,
+                                           count_memo)
+        : generator.for_each_valid_schedule(*table, score_schedule, num_threads, 10000000, keep);
     
-    for (unsigned int i = 0; i < num_threads; ++i) {
-        size_t start_idx = i * chunk_size;
-        size_t end_idx = std::min((i + 1) * chunk_size, all_schedules.size());
-        
-        // Launch thread with async and store future for synchronization
-        futures.push_back(std::async(std::launch::async, worker_function, start_idx, end_idx));
+    if (!silent_mode_) {
+        if (sampling) {
+            std::cout << "Scored a uniform sample of " << total_schedules << " schedules\n";
+        } else if (bound) {
+            std::cout << "Scored " << total_schedules << " schedules that could reach the top " << top_n << "\n";
+        } else {
+            size_t represented = 0;
+            for (const auto& state : workers) represented += state.represented;
+            std::cout << "Found " << represented << " valid schedules ("
+                      << total_schedules << " distinct time signatures)\n";
+        }
     }
     
-    // Wait for all threads to complete
-    for (auto& future : futures) {
-        future.wait();
+    if (total_schedules == 0) {
+        if (!silent_mode_) {
+            std::cout << "No valid schedules found!\n";
+        }
+        next.started = next.exhausted = true;
+        return {};
     }
     
     // Final timing
     auto end_time = std::chrono::high_resolution_clock::now();
     auto total_elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time).count();
     if (!silent_mode_) {
-        std::cout << "Total scoring time: " << total_elapsed << "ms for " << all_schedules.size() 
-                << " schedules (" << (total_elapsed / (double)all_schedules.size()) << "ms per schedule)" << std::endl;
+        std::cout << "Total generation + scoring time: " << total_elapsed << "ms for " << total_schedules
+                << " schedules (" << (total_elapsed / (double)total_schedules) << "ms per schedule)" << std::endl;
     }
     
-    // Convert top schedules to result vector
-    std::vector<Schedule> result;
-    result.reserve(top_schedules.size());
-    
-    // Extract all elements from the heap in ascending score order
-    std::vector<std::pair<double, Schedule>> sorted_schedules;
-    while (!top_schedules.empty()) {
-        sorted_schedules.push_back(top_schedules.top());
-        top_schedules.pop();
+    // Merge the per-worker heaps and keep the overall top_n, highest first
+    std::vector<ScoredSchedule> sorted_schedules;
+    for (auto& state : workers) {
+        for (auto& entry : state.top) sorted_schedules.push_back(std::move(entry));
+    }
+    std::sort(sorted_schedules.begin(), sorted_schedules.end(), better);
+    if (sorted_schedules.size() > static_cast<size_t>(top_n)) {
+        sorted_schedules.erase(sorted_schedules.begin() + top_n, sorted_schedules.end());
     }
     
-    // Reverse to get descending order (highest scores first)
-    std::reverse(sorted_schedules.begin(), sorted_schedules.end());
-    
-    // Convert to vector of {Schedule, score} pairs
+    // Convert to vector of {Schedule, score} pairs, expanding each packed
+    // schedule into the equally scored schedules it stands for
     std::vector<std::pair<Schedule, double>> schedules_with_scores;
-    for (const auto& [score, schedule] : sorted_schedules) {
-        schedules_with_scores.push_back({schedule, score});
+    for (const auto& entry : sorted_schedules) {
+        size_t room = static_cast<size_t>(top_n) - schedules_with_scores.size();
+        if (room == 0) break;
+        auto expanded = table->expand(entry.ids, room, entry.first);
+        next.score = entry.score;
+        next.ids = entry.ids;
+        next.expansion = entry.first + expanded.size();
+        for (auto& full : expanded) {
+            schedules_with_scores.push_back({std::move(full), entry.score});
+        }
     }
+    next.started = true;
+    next.page = after.page + 1;
+    next.exhausted = schedules_with_scores.size() < static_cast<size_t>(top_n);
     
     // Apply diversity algorithm to get varied schedules
     if (!silent_mode_) {
@@ -243,9 +368,9 @@ void Scheduler::print_schedule(const Schedule& schedule, bool include_scores) co
     
     // Group by class code for cleaner display
     std::map<std::string, std::vector<Section>> classes;
-    for (const auto& [spot_idx, class_code, pkg_idx, sections] : schedule) {
-        for (const auto& section : sections) {
-            classes[class_code].push_back(section);
+    for (const auto& item : schedule) {
+        for (const auto& section : item.sections) {
+            classes[item.class_code].push_back(section);
         }
     }
     
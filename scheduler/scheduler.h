@@ -1,8 +1,12 @@
 #pragma once
-#include "database.h"
+#include "catalog_source.h"
 #include "schedule_generator.h"
 #include "schedule_evaluator.h"
 #include "user_preferences.h"
+#include "schedule_cursor.h"
+#include "connection_pool.h"
+#include "rating_cache.h"
+#include <chrono>
 #include <vector>
 #include <string>
 #include <map>
@@ -13,7 +17,7 @@
 
 class Scheduler {
 public:
-    Scheduler(std::shared_ptr<DatabaseConnection> db, bool silent_mode = false);
+    Scheduler(std::shared_ptr<CatalogSource> db, bool silent_mode = false);
     
     // Main entry point - build optimal schedules
     std::vector<std::pair<Schedule, double>> build_schedule(
@@ -22,17 +26,77 @@ public:
         int top_n = 10,
         bool silent = false); // Add this parameter
     
+    // One page of the ranking: the top_n schedules after `after` (a default
+    // cursor for the first page). `next` receives the cursor for the page
+    // after this one; it is marked exhausted once a page comes back short.
+    // Throws std::invalid_argument for a cursor from a different request.
+    // The search is not resumed, only the ranking: page N enumerates and
+    // scores the schedules of pages 1..N-1 again before skipping them (the
+    // bound can only prune from below), so its cost grows with N.
+    std::vector<std::pair<Schedule, double>> build_schedule_page(
+        const std::vector<std::vector<std::string>>& class_spots,
+        const UserPreferences& user_prefs,
+        int top_n,
+        const ScheduleCursor& after,
+        ScheduleCursor& next,
+        bool silent = false);
+    
+    // How many valid schedules exist, without scoring or building any
+    // (zero when some spot has no usable package)
+    ScheduleCount count_schedules(
+        const std::vector<std::vector<std::string>>& class_spots,
+        const UserPreferences& user_prefs = UserPreferences());
+    
     // Get detailed scoring breakdown for a schedule
     std::map<std::string, double> get_schedule_score_breakdown(
         const Schedule& schedule,
         const UserPreferences& user_prefs = UserPreferences());
     
+    // Score every valid schedule instead of pruning with score upper bounds
+    // (same top_n, much slower; for comparison and debugging)
+    void set_exhaustive_search(bool exhaustive) { exhaustive_search_ = exhaustive; }
+    
+    // When a request has more than `budget` distinct schedules, rank a
+    // uniform random sample of `budget` of them instead of searching them
+    // all (0 turns sampling off). A zero seed derives one from the request,
+    // so every page of a request ranks the same sample.
+    void set_sampling(size_t budget, uint64_t seed = 0) { sample_budget_ = budget; sample_seed_ = seed; }
+    
+    // Connections the rating lookups of a request borrow: the prefetch, then
+    // package_ratings, one at a time (scoring itself reads the per-package
+    // table and never queries). The default pool lends this Scheduler's own
+    // connection, so a request opens none of its own. Share one pool between
+    // Schedulers to cap connections across all of them; such a pool must not
+    // lend any Scheduler's own connection (lend_like = false).
+    void set_connection_pool(std::shared_ptr<ConnectionPool> pool) { pool_ = std::move(pool); }
+    const std::shared_ptr<ConnectionPool>& connection_pool() const { return pool_; }
+    
+    // Keep professor ratings across requests in an LRU cache of at most
+    // `capacity` entries (0 = unbounded, the default), each trusted for
+    // `ttl` after it was fetched (0 = forever). With a file, the cache starts
+    // from it and is written back whenever a request fetched ratings, so
+    // separate runs share it. Replaces the current cache.
+    void set_rating_cache(size_t capacity, std::chrono::seconds ttl, std::string file = "");
+    const RatingCache& rating_cache() const { return rating_cache_; }
+
+    // An instructor's rating for a class through the rating cache: what the
+    // last request scored with, without querying again (e.g. when printing
+    // its schedules)
+    CatalogSource::ProfessorRating professor_rating(const std::string& instructor,
+                                                    const std::string& class_code);
+    
     // Print a schedule in human-readable format
     void print_schedule(const Schedule& schedule, bool include_scores = false) const;
 
 private:
-    std::shared_ptr<DatabaseConnection> db_;
+    std::shared_ptr<CatalogSource> db_;
+    std::shared_ptr<ConnectionPool> pool_;
     bool silent_mode_; // Add this flag
+    bool exhaustive_search_ = false;
+    size_t sample_budget_ = 0;
+    uint64_t sample_seed_ = 0;
+    RatingCache rating_cache_;        // kept across requests
+    std::string rating_cache_file_;   // where rating_cache_ persists, if anywhere
     ScheduleGenerator generator;
     ScheduleEvaluator evaluator;
 };
\ No newline at end of file
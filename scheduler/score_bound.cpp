@@ -0,0 +1,102 @@
+// score_bound.cpp
+#include "score_bound.h"
+#include <algorithm>
+
+namespace {
+// Keep the larger (or smaller) of two averages, where -1 means "none yet"
+double keep_max(double best, double value) {
+    if (value < 0) return best;
+    return best < 0 ? value : std::max(best, value);
+}
+double keep_min(double best, double value) {
+    if (value < 0) return best;
+    return best < 0 ? value : std::min(best, value);
+}
+}
+
+ScoreBound::ScoreBound(const PackageTable& table, const UserPreferences& prefs,
+                       const ScheduleEvaluator& evaluator, const ScheduleEvaluator::PackageRatings& ratings)
+    : time_pref_(prefs.get_time_of_day_preference()),
+      length_pref_(prefs.get_lecture_length_preference()),
+      avoid_any_(prefs.get_avoid_labs() || prefs.get_avoid_discussions()) {
+
+    static const char* day_names[] = {"Mon", "Tue", "Wed", "Thu", "Fri"};
+    for (const auto& day : prefs.get_days_off())
+        for (int d = 0; d < 5; ++d)
+            if (day == day_names[d]) unwanted_days_ |= 1u << d;
+    if (!prefs.get_days_off().empty() && unwanted_days_ == 0) unwanted_days_ = 0x80; // no Mon..Fri match
+
+    const size_t n = table.spots.size();
+    packages_.resize(n);
+    max_rating_avg_.assign(n, -1);
+    min_difficulty_avg_.assign(n, -1);
+    min_lecture_avg_.assign(n, -1);
+    max_lecture_avg_.assign(n, -1);
+
+    for (size_t spot = 0; spot < n; ++spot) {
+        for (size_t id = 0; id < table.spots[spot].size(); ++id) {
+            packages_[spot].push_back(evaluator.summarize_package(table.spots[spot][id], prefs, ratings[spot][id]));
+
+            const PackageScore& p = packages_[spot].back();
+            if (p.rated > 0) {
+                max_rating_avg_[spot]     = keep_max(max_rating_avg_[spot], p.rating_sum / p.rated);
+                min_difficulty_avg_[spot] = keep_min(min_difficulty_avg_[spot], p.difficulty_sum / p.rated);
+            }
+            if (p.lectures > 0) {
+                min_lecture_avg_[spot] = keep_min(min_lecture_avg_[spot], p.lecture_hours / p.lectures);
+                max_lecture_avg_[spot] = keep_max(max_lecture_avg_[spot], p.lecture_hours / p.lectures);
+            }
+        }
+    }
+}
+
+double ScoreBound::upper_bound(const PackedSchedule& partial) const {
+    PackageScore sum;
+    double rating = -1, difficulty = -1, lo = -1, hi = -1;   // best reachable averages
+    for (size_t spot = 0; spot < partial.size(); ++spot) {
+        if (partial[spot] == NO_PACKAGE) {
+            rating     = keep_max(rating, max_rating_avg_[spot]);
+            difficulty = keep_min(difficulty, min_difficulty_avg_[spot]);
+            lo         = keep_min(lo, min_lecture_avg_[spot]);
+            hi         = keep_max(hi, max_lecture_avg_[spot]);
+            continue;
+        }
+        const PackageScore& p = packages_[spot][partial[spot]];
+        sum.rating_sum     += p.rating_sum;
+        sum.difficulty_sum += p.difficulty_sum;
+        sum.rated          += p.rated;
+        sum.day_bits       |= p.day_bits;
+        sum.out_of_zone    += p.out_of_zone;
+        sum.lecture_hours  += p.lecture_hours;
+        sum.lectures       += p.lectures;
+        sum.avoided        += p.avoided;
+    }
+    double bound = 0;
+
+    /* professor: averages of the chosen ratings mixed with the best still reachable */
+    if (sum.rated > 0) {
+        rating     = keep_max(rating, sum.rating_sum / sum.rated);
+        difficulty = keep_min(difficulty, sum.difficulty_sum / sum.rated);
+    }
+    if (rating >= 0) bound += 2.0 * rating + 2.0 * (5.0 - std::min(5.0, std::max(0.0, difficulty)));
+
+    /* days off and time of day only ever lose points */
+    if (unwanted_days_) bound += std::max(0, 20 - 5 * __builtin_popcount(sum.day_bits & unwanted_days_));
+    if (time_pref_ != 0) bound += std::max(0, 20 - 5 * sum.out_of_zone);
+
+    /* lecture length: the average can't leave the range of reachable averages */
+    if (length_pref_ != 0) {
+        if (sum.lectures > 0) {
+            lo = keep_min(lo, sum.lecture_hours / sum.lectures);
+            hi = keep_max(hi, sum.lecture_hours / sum.lectures);
+        }
+        if (lo >= 0) {
+            double best = length_pref_ < 0 ? std::min(1.5, std::max(0.0, 1.5 - lo))
+                                           : std::min(1.5, std::max(0.0, hi - 1.5));
+            bound += best / 1.5 * 10.0;
+        }
+    }
+
+    if (avoid_any_) bound += std::max(0, 2 - sum.avoided) * 5.0;
+    return bound;
+}
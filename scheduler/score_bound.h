@@ -0,0 +1,36 @@
+// score_bound.h
+#pragma once
+#include "schedule_evaluator.h"
+#include "schedule_generator.h"
+#include "user_preferences.h"
+#include <vector>
+
+// Optimistic score for partial schedules, used to prune the top-k search.
+// Every bundle is rebuilt from per-package sums: the day, time and lab/disc
+// bundles can only lose points as packages are added, and the averaged
+// bundles (professor ratings, lecture length) can never beat the best
+// package average still reachable. The bound therefore never underestimates
+// any completion of the partial schedule.
+class ScoreBound {
+public:
+    ScoreBound(const PackageTable& table, const UserPreferences& prefs,
+               const ScheduleEvaluator& evaluator, const ScheduleEvaluator::PackageRatings& ratings);
+
+    // Highest raw (0-100) score reachable from `partial` (NO_PACKAGE for
+    // spots the search has not filled yet)
+    double upper_bound(const PackedSchedule& partial) const;
+
+private:
+    std::vector<std::vector<PackageScore>> packages_;   // [spot][package]
+
+    // Best per-package averages of each spot; -1 when no package there has any
+    std::vector<double> max_rating_avg_;
+    std::vector<double> min_difficulty_avg_;
+    std::vector<double> min_lecture_avg_;
+    std::vector<double> max_lecture_avg_;
+
+    uint8_t unwanted_days_ = 0;
+    int time_pref_ = 0;
+    int length_pref_ = 0;
+    bool avoid_any_ = false;
+};
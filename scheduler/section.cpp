@@ -14,15 +14,15 @@ Section::Section(std::string sectionType,
                  std::string instructor,
                  std::string section_number,
                  std::string parent_section_number)
-    : sectionType(sectionType),
-      meeting_days(meeting_days),
-      meeting_times(meeting_times),
-      location(location),
+    : sectionType(std::move(sectionType)),
+      meeting_days(meeting_days),   // the body below still reads the parameter
+      meeting_times(std::move(meeting_times)),
+      location(std::move(location)),
       num_registered(num_registered),
       num_seats(num_seats),
-      instructor(instructor),
-      section_number(section_number),
-      parent_section_number(parent_section_number) {
+      instructor(std::move(instructor)),
+      section_number(std::move(section_number)),
+      parent_section_number(std::move(parent_section_number)) {
     
     // Process the meeting days
     for (const auto& day_string : meeting_days) {
@@ -62,6 +62,11 @@ Section::Section(std::string sectionType,
             }
         }
     }
+
+    // Compile days/times once so conflict checks don't re-parse strings
+    day_bits = compute_day_bits();
+    start_minute = TimeUtils::get_minute_of_day(this->meeting_times.first);
+    end_minute = TimeUtils::get_minute_of_day(this->meeting_times.second);
 }
 
 bool Section::conflicts_with(const Section& other) const {
@@ -172,9 +177,20 @@ std::string Section::get_section_number() const {
     return section_number;
 }
 
-// Assuming you have a day bits implementation
 uint8_t Section::get_day_bits() const {
-    // This is a placeholder - make sure your actual implementation is here
+    return day_bits;
+}
+
+int Section::get_start_minute() const {
+    return start_minute;
+}
+
+int Section::get_end_minute() const {
+    return end_minute;
+}
+
+// Bit 0 = Monday ... bit 6 = Sunday
+uint8_t Section::compute_day_bits() const {
     uint8_t bits = 0;
     for (const auto& day : meeting_days) {
         // Monday
@@ -40,6 +40,10 @@ public:
     uint8_t get_day_bits() const;        // Remove any implementation
     int get_num_registered_students() const;  // Returns the number of enrolled students
 
+    // Meeting times compiled once at construction: minutes since midnight, -1 if TBA/unparsable
+    int get_start_minute() const;
+    int get_end_minute() const;
+
 private:
     std::string sectionType;
     std::vector<std::string> meeting_days;
@@ -50,4 +54,10 @@ private:
     std::string instructor;
     std::string section_number;
     std::string parent_section_number;
+
+    // Compiled from the strings above so hot paths never re-parse them
+    uint8_t day_bits = 0;
+    int start_minute = -1;
+    int end_minute = -1;
+    uint8_t compute_day_bits() const;
 };
@@ -6,6 +6,7 @@
 #include <regex>
 #include <algorithm>
 #include <vector>
+#include <cmath>
 
 double TimeUtils::get_hour_from_time_string(const std::string& time_str) {
     if (time_str.empty() || time_str == "TBA") {
@@ -52,6 +53,14 @@ double TimeUtils::get_hour_from_time_string(const std::string& time_str) {
     return hour + minute / 60.0;
 }
 
+int TimeUtils::get_minute_of_day(const std::string& time_str) {
+    double hour = get_hour_from_time_string(time_str);
+    if (hour < 0) {
+        return -1;
+    }
+    return static_cast<int>(std::lround(hour * 60.0));
+}
+
 std::vector<std::string> TimeUtils::split_string(const std::string& str, char delimiter) {
     std::vector<std::string> result;
     std::stringstream ss(str);
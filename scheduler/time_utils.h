@@ -7,6 +7,9 @@ public:
     // Convert a time string (e.g., "2:00 pm") to hour (e.g., 14.0)
     static double get_hour_from_time_string(const std::string& time_str);
     
+    // Convert a time string (e.g., "2:00 pm") to minutes since midnight (e.g., 840), -1 if invalid
+    static int get_minute_of_day(const std::string& time_str);
+    
     // Get minutes between two time strings
     static int get_minutes_between(const std::string& start_time, const std::string& end_time);
     
@@ -0,0 +1,180 @@
+// week_mask.cpp
+#include "week_mask.h"
+#include "section.h"
+#include <algorithm>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define WEEK_MASK_X86 1
+#endif
+
+void WeekMask::add_meeting(uint8_t day_bits, int start_min, int end_min) {
+    if (start_min < 0 || end_min < 0) return;        // TBA / unparsable
+    if (end_min < start_min) end_min = 24 * 60;      // overnight → clip at midnight
+    end_min = std::min(end_min, 24 * 60);
+    if (end_min <= start_min) return;
+
+    if (start_min % SLOT_MINUTES != 0 || end_min % SLOT_MINUTES != 0) exact = false;
+    int first_slot = start_min / SLOT_MINUTES;
+    int end_slot   = (end_min + SLOT_MINUTES - 1) / SLOT_MINUTES;   // round up
+
+    for (int day = 0; day < DAYS; ++day) {
+        if (!(day_bits & (1u << day))) continue;
+        for (int slot = day * SLOTS_PER_DAY + first_slot;
+             slot < day * SLOTS_PER_DAY + end_slot; ++slot) {
+            words[slot / 64] |= uint64_t(1) << (slot % 64);
+        }
+        first_word = std::min<int>(first_word, (day * SLOTS_PER_DAY + first_slot) / 64);
+        last_word  = std::max<int>(last_word,  (day * SLOTS_PER_DAY + end_slot - 1) / 64);
+    }
+}
+
+void WeekMask::merge(const WeekMask& other) {
+    if (other.empty()) { exact = exact && other.exact; return; }
+    for (int w = other.first_word; w <= other.last_word; ++w) words[w] |= other.words[w];
+    first_word = std::min(first_word, other.first_word);
+    last_word  = std::max(last_word,  other.last_word);
+    exact = exact && other.exact;
+}
+
+WeekMask WeekMask::of(const Section& section) {
+    WeekMask mask;
+    mask.add_meeting(section.get_day_bits(), section.get_start_minute(), section.get_end_minute());
+    return mask;
+}
+
+WeekMask WeekMask::of(const std::vector<Section>& sections) {
+    WeekMask mask;
+    for (const auto& section : sections) mask.merge(of(section));
+    return mask;
+}
+
+namespace {
+
+constexpr size_t LANES = WeekMaskBlock::LANES;
+constexpr size_t TILE_WORDS = WeekMask::WORDS * LANES;
+
+// The query's non-zero words inside the block's span; only these can hit
+struct QueryWords {
+    int count = 0;
+    int index[WeekMask::WORDS];
+    uint64_t value[WeekMask::WORDS];
+};
+
+void disjoint_scalar(const uint64_t* tiles, size_t num_tiles, const QueryWords& query,
+                     uint64_t* out) {
+    for (size_t t = 0; t < num_tiles; ++t) {
+        const uint64_t* tile = tiles + t * TILE_WORDS;
+        uint64_t hit[LANES] = {};
+        for (int k = 0; k < query.count; ++k) {
+            const uint64_t* lanes = tile + query.index[k] * LANES;
+            for (size_t l = 0; l < LANES; ++l) hit[l] |= lanes[l] & query.value[k];
+        }
+        uint64_t bits = 0;
+        for (size_t l = 0; l < LANES; ++l) bits |= uint64_t(hit[l] == 0) << l;
+        out[t * LANES / 64] |= bits << (t * LANES % 64);
+    }
+}
+
+#ifdef WEEK_MASK_X86
+__attribute__((target("avx2")))
+inline uint64_t disjoint_lanes(__m256i hit) {
+    return uint64_t(_mm256_movemask_pd(_mm256_castsi256_pd(
+        _mm256_cmpeq_epi64(hit, _mm256_setzero_si256()))));
+}
+
+// One 256-bit load covers the same word of a whole tile; two tiles per
+// iteration to keep both load ports busy
+__attribute__((target("avx2")))
+void disjoint_avx2(const uint64_t* tiles, size_t num_tiles, const QueryWords& query,
+                   uint64_t* out) {
+    __m256i value[WeekMask::WORDS];
+    for (int k = 0; k < query.count; ++k)
+        value[k] = _mm256_set1_epi64x(static_cast<long long>(query.value[k]));
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t t = 0;
+    for (; t + 2 <= num_tiles; t += 2) {
+        const uint64_t* tile0 = tiles + t * TILE_WORDS;
+        const uint64_t* tile1 = tile0 + TILE_WORDS;
+        __m256i hit0 = zero, hit1 = zero;
+        for (int k = 0; k < query.count; ++k) {
+            const size_t at = size_t(query.index[k]) * LANES;
+            hit0 = _mm256_or_si256(hit0, _mm256_and_si256(value[k],
+                       _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tile0 + at))));
+            hit1 = _mm256_or_si256(hit1, _mm256_and_si256(value[k],
+                       _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tile1 + at))));
+        }
+        uint64_t bits = disjoint_lanes(hit0) | disjoint_lanes(hit1) << LANES;
+        out[t * LANES / 64] |= bits << (t * LANES % 64);
+    }
+    if (t < num_tiles) {
+        const uint64_t* tile = tiles + t * TILE_WORDS;
+        __m256i hit = zero;
+        for (int k = 0; k < query.count; ++k)
+            hit = _mm256_or_si256(hit, _mm256_and_si256(value[k], _mm256_loadu_si256(
+                      reinterpret_cast<const __m256i*>(tile + size_t(query.index[k]) * LANES))));
+        out[t * LANES / 64] |= disjoint_lanes(hit) << (t * LANES % 64);
+    }
+}
+#endif
+
+} // namespace
+
+WeekMaskBlock::WeekMaskBlock(const std::vector<const WeekMask*>& masks) : size_(masks.size()) {
+    const size_t num_tiles = (size_ + LANES - 1) / LANES;
+    tiles_.assign(num_tiles * TILE_WORDS, 0);   // padding lanes stay empty
+    for (size_t i = 0; i < size_; ++i) {
+        const WeekMask& mask = *masks[i];
+        if (mask.empty()) continue;
+        uint64_t* tile = tiles_.data() + (i / LANES) * TILE_WORDS;
+        for (int w = mask.first_word; w <= mask.last_word; ++w) tile[w * LANES + i % LANES] = mask.words[w];
+        first_word_ = std::min<int>(first_word_, mask.first_word);
+        last_word_  = std::max<int>(last_word_,  mask.last_word);
+    }
+}
+
+bool WeekMaskBlock::simd_available() {
+#ifdef WEEK_MASK_X86
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+#else
+    return false;
+#endif
+}
+
+void WeekMaskBlock::disjoint_from(const WeekMask& query, uint64_t* out, bool allow_simd) const {
+    const size_t num_words = (size_ + 63) / 64;
+    std::fill_n(out, num_words, 0);
+
+    QueryWords words;
+    const int lo = std::max<int>(first_word_, query.first_word);
+    const int hi = std::min<int>(last_word_, query.last_word);
+    for (int w = lo; w <= hi; ++w)
+        if (query.words[w]) {
+            words.index[words.count] = w;
+            words.value[words.count++] = query.words[w];
+        }
+
+    const size_t num_tiles = (size_ + LANES - 1) / LANES;
+#ifdef WEEK_MASK_X86
+    if (allow_simd && simd_available()) disjoint_avx2(tiles_.data(), num_tiles, words, out);
+    else disjoint_scalar(tiles_.data(), num_tiles, words, out);
+#else
+    (void)allow_simd;
+    disjoint_scalar(tiles_.data(), num_tiles, words, out);
+#endif
+    if (size_t tail = size_ % 64) out[num_words - 1] &= (uint64_t(1) << tail) - 1;
+}
+
+bool meetings_overlap(const Section& a, const Section& b) {
+    if ((a.get_day_bits() & b.get_day_bits()) == 0) return false;
+
+    int start1 = a.get_start_minute(), end1 = a.get_end_minute();
+    int start2 = b.get_start_minute(), end2 = b.get_end_minute();
+    if (start1 < 0 || end1 < 0 || start2 < 0 || end2 < 0) return false;
+
+    // Handle overnight times
+    if (end1 < start1) end1 += 24 * 60;
+    if (end2 < start2) end2 += 24 * 60;
+    return start1 < end2 && start2 < end1;
+}
@@ -0,0 +1,73 @@
+// week_mask.h
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class Section;
+
+// Occupancy of one week as a bitmap of 5-minute slots (7 days x 288 slots).
+// Sections and packages are compiled into a mask once when they are loaded,
+// so a conflict test becomes a few 64-bit ANDs instead of parsing
+// "2:00 pm" style strings for every pair of sections.
+struct WeekMask {
+    static constexpr int SLOT_MINUTES  = 5;
+    static constexpr int SLOTS_PER_DAY = 24 * 60 / SLOT_MINUTES;      // 288
+    static constexpr int DAYS          = 7;                           // Mon..Sun
+    static constexpr int WORDS         = (DAYS * SLOTS_PER_DAY + 63) / 64;
+
+    std::array<uint64_t, WORDS> words{};
+    uint8_t first_word = WORDS;   // occupied word span, lets intersects() skip empty words
+    uint8_t last_word  = 0;
+    bool exact = true;            // false if a meeting does not start/end on a slot boundary
+
+    // Mark [start_min, end_min) on every day in `day_bits` (bit 0 = Monday).
+    // Meetings past midnight are clipped to the end of their day.
+    void add_meeting(uint8_t day_bits, int start_min, int end_min);
+    void merge(const WeekMask& other);
+
+    bool empty() const { return first_word > last_word; }
+    bool intersects(const WeekMask& other) const {
+        int lo = first_word > other.first_word ? first_word : other.first_word;
+        int hi = last_word  < other.last_word  ? last_word  : other.last_word;
+        for (int w = lo; w <= hi; ++w)
+            if (words[w] & other.words[w]) return true;
+        return false;
+    }
+
+    static WeekMask of(const Section& section);
+    static WeekMask of(const std::vector<Section>& sections);
+};
+
+// Occupancy masks of many packages in one contiguous block, laid out as tiles
+// of LANES packages with the tile's masks interleaved word by word
+// ([tile][word][lane]), so one package can be tested against all of them
+// with wide loads. Used to fill whole compatibility rows at once.
+class WeekMaskBlock {
+public:
+    static constexpr size_t LANES = 4;
+
+    WeekMaskBlock() = default;
+    explicit WeekMaskBlock(const std::vector<const WeekMask*>& masks);
+
+    size_t size() const { return size_; }
+
+    // Bit i of `out` ((size + 63) / 64 words) set when mask i shares no slot
+    // with `query`; padding bits clear. Uses AVX2 when the CPU has it,
+    // unless `allow_simd` is false.
+    void disjoint_from(const WeekMask& query, uint64_t* out, bool allow_simd = true) const;
+
+    static bool simd_available();
+
+private:
+    size_t size_ = 0;
+    std::vector<uint64_t> tiles_;
+    int first_word_ = WeekMask::WORDS;   // occupied word span over every mask
+    int last_word_  = -1;
+};
+
+// Minute-exact overlap test for two sections on their compiled days/times.
+// Only needed to confirm a mask hit when one of the masks is not exact.
+bool meetings_overlap(const Section& a, const Section& b);
+
@@ -0,0 +1,123 @@
+// work_stealing_pool.cpp
+#include "work_stealing_pool.h"
+
+WorkStealingPool::WorkStealingPool(unsigned num_workers) {
+    if (num_workers == 0) num_workers = 1;
+    for (unsigned w = 0; w < num_workers; ++w) queues_.push_back(std::make_unique<Queue>());
+    for (unsigned w = 1; w < num_workers; ++w) threads_.emplace_back(&WorkStealingPool::helper_loop, this, w);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(run_mutex_);
+        shutting_down_ = true;
+    }
+    run_cv_.notify_all();
+    for (auto& thread : threads_) thread.join();
+}
+
+void WorkStealingPool::run(std::vector<Task> roots) {
+    if (roots.empty()) return;
+
+    // Deal the roots round-robin so every worker starts with something local
+    pending_ = roots.size();
+    for (size_t i = 0; i < roots.size(); ++i) {
+        Queue& queue = *queues_[i % queues_.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(roots[i]));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(run_mutex_);
+        ++generation_;
+        active_ = static_cast<unsigned>(threads_.size());
+    }
+    run_cv_.notify_all();
+
+    work(0);
+
+    // Helpers may still be finishing their last task
+    std::unique_lock<std::mutex> lock(run_mutex_);
+    run_cv_.wait(lock, [this] { return active_ == 0; });
+}
+
+void WorkStealingPool::spawn(unsigned worker, Task task) {
+    pending_.fetch_add(1);
+    {
+        Queue& queue = *queues_[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    // A worker going idle right now bumps idle_ before its last look at
+    // wakeups_, so either it sees this bump or we see it idle
+    wakeups_.fetch_add(1);
+    if (idle_.load() > 0) {
+        { std::lock_guard<std::mutex> lock(wake_mutex_); }
+        wake_cv_.notify_one();
+    }
+}
+
+bool WorkStealingPool::pop_local(unsigned worker, Task& task) {
+    Queue& queue = *queues_[worker];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) return false;
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned thief, Task& task) {
+    const unsigned n = size();
+    for (unsigned k = 1; k < n; ++k) {
+        Queue& queue = *queues_[(thief + k) % n];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::work(unsigned worker) {
+    Task task;
+    bool idle = false;
+    while (pending_.load() > 0) {
+        const size_t seen = wakeups_.load();
+        if (pop_local(worker, task) || steal(worker, task)) {
+            if (idle) { idle_.fetch_sub(1); idle = false; }
+            task(worker);
+            task = nullptr;
+            if (pending_.fetch_sub(1) == 1) {
+                // The run is over; release everyone asleep below
+                { std::lock_guard<std::mutex> lock(wake_mutex_); }
+                wake_cv_.notify_all();
+            }
+        } else {
+            // Tasks are still running elsewhere and may split; advertise and
+            // sleep until one does or the run ends
+            if (!idle) { idle_.fetch_add(1); idle = true; }
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_cv_.wait(lock, [&] { return pending_.load() == 0 || wakeups_.load() != seen; });
+        }
+    }
+    if (idle) idle_.fetch_sub(1);
+}
+
+void WorkStealingPool::helper_loop(unsigned worker) {
+    size_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(run_mutex_);
+            run_cv_.wait(lock, [&] { return shutting_down_ || generation_ != seen; });
+            if (shutting_down_) return;
+            seen = generation_;
+        }
+        work(worker);
+        {
+            std::lock_guard<std::mutex> lock(run_mutex_);
+            --active_;
+        }
+        run_cv_.notify_all();
+    }
+}
@@ -0,0 +1,69 @@
+// work_stealing_pool.h
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Persistent pool of search threads with one task deque per worker. A worker
+// pops its own newest task (depth-first, cache-warm) and, when it runs dry,
+// steals the oldest task of another worker - the biggest subtree left. Tasks
+// may spawn more tasks, so a search can hand off part of its subtree as soon
+// as someone is idle instead of committing to a fixed split up front.
+//
+// The thread calling run() works as worker 0, so a pool of size 1 starts no
+// threads at all.
+class WorkStealingPool {
+public:
+    using Task = std::function<void(unsigned worker)>;
+
+    explicit WorkStealingPool(unsigned num_workers);
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(queues_.size()); }
+
+    // Run `roots` and every task they spawn; returns when all have finished.
+    // Not reentrant: one run() at a time.
+    void run(std::vector<Task> roots);
+
+    // Queue a task on `worker`'s deque; only valid from inside a running task
+    void spawn(unsigned worker, Task task);
+
+    // Hint for splitting: true while some worker is looking for work
+    bool has_idle_workers() const { return idle_.load(std::memory_order_relaxed) > 0; }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::atomic<size_t> pending_{0};    // spawned but not yet finished
+    std::atomic<unsigned> idle_{0};
+
+    // Idle workers sleep here instead of spinning; woken by spawn() (while
+    // anyone is idle) and when the last task of a run finishes
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cv_;
+    std::atomic<size_t> wakeups_{0};    // bumped by every spawn()
+
+    std::mutex run_mutex_;
+    std::condition_variable run_cv_;
+    size_t generation_ = 0;             // bumped by every run()
+    unsigned active_ = 0;               // helper threads still inside the current run
+    bool shutting_down_ = false;
+
+    bool pop_local(unsigned worker, Task& task);
+    bool steal(unsigned thief, Task& task);
+    void work(unsigned worker);         // until the current run has drained
+    void helper_loop(unsigned worker);
+};
@@ -0,0 +1,17 @@
+-- Canonical lookup keys for professor ratings: lowercase, letters and digits
+-- only, the same normalisation the scheduler applies to the names and course
+-- codes it looks up. Stored as generated columns so the ingestion scripts
+-- need no change, and indexed so a bulk lookup is an index probe per pair
+-- instead of a regexp over every row.
+ALTER TABLE professors
+  ADD COLUMN IF NOT EXISTS name_key TEXT
+  GENERATED ALWAYS AS (lower(regexp_replace(name, '[^A-Za-z0-9]', '', 'g'))) STORED;
+
+CREATE INDEX IF NOT EXISTS professors_name_key_idx ON professors (name_key);
+
+ALTER TABLE prof_course_ratings
+  ADD COLUMN IF NOT EXISTS course_key TEXT
+  GENERATED ALWAYS AS (lower(regexp_replace(course_code, '[^A-Za-z0-9]', '', 'g'))) STORED;
+
+CREATE INDEX IF NOT EXISTS prof_course_ratings_course_key_idx
+  ON prof_course_ratings (professor_id, course_key, num_reviews DESC);